@@ -12,11 +12,16 @@
 
 #define DEBUG_LEVEL "debug"
 
+unsigned long get_frac_sec_value(unsigned long fracsec);
+
 FC37118::FC37118() : m_conf(nullptr),
                      m_config_frame(nullptr),
                      m_data_frame(nullptr),
+                     m_config_version(0),
+                     m_dictionary_config_version(0),
                      m_is_running(false),
-                     m_sockfd(0)
+                     m_expected_data_frame_size(0),
+                     m_expected_size_version(0)
 {
     Logger::getLogger()->setMinLevel(DEBUG_LEVEL);
 }
@@ -28,6 +33,7 @@ FC37118::~FC37118()
     {
         stop();
     }
+    m_clear_paths();
     delete m_config_frame;
     delete m_data_frame;
     delete m_conf;
@@ -38,20 +44,79 @@ void FC37118::start()
     Logger::getLogger()->setMinLevel(DEBUG_LEVEL);
 
     Logger::getLogger()->info("Start");
+    if (m_conf->is_capture() && !m_conf->is_replay())
+        m_capture.open(m_conf->get_capture_file());
+    if (m_archive.is_enabled() && !m_conf->is_replay())
+        m_archive.open();
+    if (m_conf->get_queue_conf()->is_enabled())
+        m_ingest_queue.start(m_conf->get_queue_conf(), [this](const FC37118Reading &reading)
+                             { m_ingest_reading(reading, FC37118Lane::BULK); });
+    if (m_shm.is_enabled())
+        m_shm.open();
+    if (m_soak.is_enabled())
+        m_soak.start();
+    if (m_server.is_enabled())
+        m_server.start();
+    if (m_conf->get_parallel_conf()->is_enabled())
+        m_conversion_pool.start(m_conf->get_parallel_conf()->get_nb_workers(), m_conf->get_parallel_conf()->get_cpus());
+    // SENDER_HARD_CONFIG: the configuration is known before any frame is received
+    if (m_conf->is_dictionary_labels() && m_c37118_configuration_ready)
+        m_publish_dictionary();
     m_is_running = true;
-    m_receiving_thread = new std::thread(&FC37118::m_receiveAndPushDatapoints, this);
+    for (auto path : m_paths)
+    {
+        path->thread = new std::thread(&FC37118::m_receiveAndPushDatapoints, this, path);
+        if (m_conf->is_replay())
+            break;
+    }
 }
 
 void FC37118::stop()
 {
     m_is_running = false;
-    close(m_sockfd);
-    if (m_receiving_thread != nullptr)
+    for (auto path : m_paths)
+    {
+        // shutdown wakes up a receive blocked in io_uring
+        if (path->sockfd > 0)
+        {
+            shutdown(path->sockfd, SHUT_RDWR);
+            close(path->sockfd);
+        }
+    }
+    for (auto path : m_paths)
     {
-        Logger::getLogger()->info("waiting receiving thread to stop");
-        m_receiving_thread->join();
-        delete m_receiving_thread;
+        if (path->thread != nullptr)
+        {
+            Logger::getLogger()->info("waiting receiving thread of " + path->name + " to stop");
+            path->thread->join();
+            delete path->thread;
+            path->thread = nullptr;
+        }
+        path->tls.close();
+        path->uring.close();
+    }
+    if (m_chunker.is_enabled())
+    {
+        std::vector<FC37118Reading> output;
+        m_chunker.flush(output);
+        for (auto &reading : output)
+            m_push(reading);
     }
+    if (m_trigger.is_enabled())
+    {
+        std::vector<FC37118Reading> output;
+        m_trigger.flush(output);
+        for (auto &reading : output)
+            m_push(reading);
+    }
+    m_conversion_pool.stop();
+    m_ingest_queue.stop();
+    m_server.stop();
+    m_shm.close();
+    m_capture.close();
+    m_archive.close();
+    if (m_soak.is_enabled())
+        m_soak.stop();
     sleep(2);
     Logger::getLogger()->info("Stoped");
 }
@@ -67,6 +132,7 @@ void FC37118::m_init_c37118()
     delete m_config_frame;
     m_config_frame = new CONFIG_Frame();
     m_data_frame = new DATA_Frame(m_config_frame);
+    m_config_version++;
 }
 
 bool FC37118::set_conf(const std::string &conf)
@@ -86,6 +152,21 @@ bool FC37118::set_conf(const std::string &conf)
         return false;
     }
     Logger::getLogger()->debug("Plugin configuration successfully ingested");
+    m_low_latency.configure(m_conf->get_low_latency_conf());
+    m_derived.configure(m_conf->get_derived_conf());
+    m_validation.configure(m_conf->get_validation_conf());
+    m_oscillation.configure(m_conf->get_oscillation_conf());
+    m_angle_difference.configure(m_conf->get_angle_difference_conf());
+    m_trigger.configure(m_conf->get_trigger_conf());
+    m_chunker.configure(m_conf->get_chunk_conf());
+    m_shm.configure(m_conf->get_shm_conf());
+    m_soak.configure(m_conf->get_soak_conf());
+    m_server.configure(m_conf->get_server_conf());
+    m_archive.configure(m_conf->get_archive_conf());
+    m_fast_lane.configure(m_conf->get_fast_lane_conf());
+    m_load_shedding.configure(m_conf->get_load_shedding_conf());
+    if (m_chunker.is_enabled() && m_trigger.is_enabled())
+        Logger::getLogger()->warn(CHUNK " output is enabled, " TRIGGER " is ignored");
 
     if (m_conf->is_request_config_to_pmu())
     {
@@ -93,17 +174,18 @@ bool FC37118::set_conf(const std::string &conf)
     }
     else
     {
-        m_init_c37118();
-        m_conf->to_conf_frame(m_config_frame);
-
-        m_c37118_configuration_ready = true;
-
-        m_log_configuration();
+        m_install_hard_config();
     }
 
-    m_serv_addr.sin_family = AF_INET;
-    m_serv_addr.sin_addr.s_addr = inet_addr(const_cast<char *>(m_conf->get_pmu_IP_addr().c_str()));
-    m_serv_addr.sin_port = htons(m_conf->get_pmu_port());
+    m_clear_paths();
+    m_paths.push_back(new FC37118Path(0, m_conf->get_pmu_IP_addr(), m_conf->get_pmu_port(), m_conf->get_tls_conf(), m_conf->get_uring_conf()));
+    for (auto &path_conf : m_conf->get_redundancy_conf()->get_paths())
+        m_paths.push_back(new FC37118Path(m_paths.size(), path_conf.ip_addr, path_conf.port, m_conf->get_tls_conf(), m_conf->get_uring_conf()));
+    std::vector<std::string> path_names;
+    for (auto path : m_paths)
+        path_names.push_back(path->name);
+    m_redundancy.configure(m_conf->get_redundancy_conf(), path_names);
+    m_config_frame_raw.clear();
     if (was_running)
     {
         Logger::getLogger()->info("Restarting");
@@ -112,26 +194,35 @@ bool FC37118::set_conf(const std::string &conf)
     return true;
 }
 
+void FC37118::m_clear_paths()
+{
+    for (auto path : m_paths)
+        delete path;
+    m_paths.clear();
+}
+
 /**
  * @brief Establish or reestablish the connection with the c37.118 equipment. Keep trying to reconnect after timeout duration.
  * Throw run_time_error if unable to create a new socket
  *
  * @return true - the connection is established
- * @return false - the terminate signal was received
+ * @return false - the terminate signal was received or the TLS handshake failed
  */
 
-bool FC37118::m_connect()
+bool FC37118::m_connect(FC37118Path *path)
 {
-    Logger::getLogger()->info("Connecting to PMU");
+    Logger::getLogger()->info("Connecting to PMU " + path->name);
 
-    m_sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (m_sockfd < 0)
+    path->sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (path->sockfd < 0)
     {
         Logger::getLogger()->fatal("FATAL error opening socket");
         throw std::runtime_error("could not initiate socket");
     }
+    m_low_latency.apply_socket(path->sockfd);
+    path->frame_reader.reset();
 
-    while (connect(m_sockfd, (struct sockaddr *)&m_serv_addr, sizeof(m_serv_addr)) != 0)
+    while (connect(path->sockfd, (struct sockaddr *)&path->serv_addr, sizeof(path->serv_addr)) != 0)
     {
         Logger::getLogger()->debug("Connection attempt in %i seconds", m_conf->get_reconnection_delay());
         sleep(m_conf->get_reconnection_delay());
@@ -141,10 +232,60 @@ bool FC37118::m_connect()
             return false;
         }
     }
-    Logger::getLogger()->info("connected to PMU");
+    Logger::getLogger()->info("connected to PMU " + path->name);
+
+    if (path->tls.is_enabled() && !path->tls.handshake(path->sockfd, inet_ntoa(path->serv_addr.sin_addr)))
+    {
+        m_disconnect(path);
+        Logger::getLogger()->debug("Connection attempt in %i seconds", m_conf->get_reconnection_delay());
+        sleep(m_conf->get_reconnection_delay());
+        return false;
+    }
+
+    if (path->uring.is_enabled())
+    {
+        if (path->tls.is_enabled())
+            Logger::getLogger()->warn(IO_URING " is not used with TLS");
+        else
+            path->uring.open(path->sockfd);
+    }
     return true;
 }
 
+/**
+ * @brief close the connection to the PMU, so that the next m_connect opens a new one
+ */
+void FC37118::m_disconnect(FC37118Path *path)
+{
+    path->tls.close();
+    path->uring.close();
+    if (path->sockfd > 0)
+    {
+        shutdown(path->sockfd, SHUT_RDWR);
+        close(path->sockfd);
+    }
+    path->sockfd = -1;
+}
+
+/**
+ * @brief read from the PMU connection, through the TLS session unless its records are decrypted by the kernel
+ *
+ * @return the number of bytes read, 0 or less if the connection is lost
+ */
+int FC37118::m_receive(FC37118Path *path, unsigned char *buffer, size_t size)
+{
+    if (path->tls.is_enabled() && !path->tls.is_kernel_rx())
+    {
+        path->arrival_ns = capture_clock_ns();
+        return path->tls.read(buffer, size);
+    }
+    int n = m_low_latency.read(path->sockfd, buffer, size, &path->arrival_ns);
+    // with kernel TLS, a TLS control record (e.g. a session ticket) cannot be read as data
+    if (n < 0 && errno == EIO && path->tls.is_enabled())
+        n = path->tls.read(buffer, size);
+    return n;
+}
+
 /**
  * @brief send a C37.118 command
  *
@@ -152,80 +293,120 @@ bool FC37118::m_connect()
  * @return true - the command was successfully sent
  * @return false - the terminate signal was received
  */
-bool FC37118::m_send_cmd(unsigned short cmd)
+bool FC37118::m_send_cmd(FC37118Path *path, unsigned short cmd)
 {
+    std::lock_guard<std::mutex> lock(m_cmd_mutex);
     unsigned char *buffer_tx;
+    m_cmd.IDCODE_set(m_conf->get_my_IDCODE());
     m_cmd.CMD_set(cmd);
     m_cmd.SOC_set((unsigned long)time(NULL));
     m_cmd.FRACSEC_set(0); // no need to be finer than the second for commands
     unsigned short size = m_cmd.pack(&buffer_tx);
-    int n = write(m_sockfd, buffer_tx, size);
+    int n = path->tls.is_enabled() ? path->tls.write(buffer_tx, size) : write(path->sockfd, buffer_tx, size);
     return n > 0;
 }
 
 /**
  * @brief Initiate the dialog with the PMU, log the header and retrieve the C37.118 configuration.
- * Once the configuration is retrieved, set configuration_ready_promise signal
+ *
+ * @return true - the configuration is retrieved
+ * @return false - the dialog failed
  */
-void FC37118::m_init_Pmu_Dialog()
+bool FC37118::m_init_Pmu_Dialog(FC37118Path *path)
 {
-    unsigned char *buffer_tx, buffer_rx[BUFFER_SIZE];
-
-    Logger::getLogger()->debug("Start PMU dialog");
+    unsigned char *frame;
+    size_t size;
 
-    m_c37118_configuration_ready = false;
-
-    m_cmd.IDCODE_set(m_conf->get_my_IDCODE());
+    Logger::getLogger()->debug("Start PMU dialog with " + path->name);
 
     Logger::getLogger()->debug("Send HDR");
 
     // Request & receive Header Frame
-    if (m_send_cmd(C37118_CMD_SEND_HDR))
+    if (!m_send_cmd(path, C37118_CMD_SEND_HDR))
+        return false;
+    Logger::getLogger()->debug("HDR sent");
+    if (m_read_frame_of_type(path, C37118_FRAME_TYPE_HEADER, &frame, &size))
     {
-        Logger::getLogger()->debug("HDR sent");
-        int size = read(m_sockfd, buffer_rx, BUFFER_SIZE);
-        if (size > 0)
-        {
-            HEADER_Frame header("");
-            header.unpack(buffer_rx);
-            Logger::getLogger()->info("header from PMU: " + header.DATA_get());
-        }
-        else
-        {
-            Logger::getLogger()->warn("Unable to retrieve c37.118 header info");
-            return;
-        }
+        HEADER_Frame header("");
+        header.unpack(frame);
+        Logger::getLogger()->info("header from PMU: " + header.DATA_get());
+        m_server.set_header(header.DATA_get());
+    }
+    else
+    {
+        Logger::getLogger()->warn("Unable to retrieve c37.118 header info");
+        return false;
     }
 
     // Request & receive Config frame
-    if (m_send_cmd(C37118_CMD_SEND_CONFIGURATION_2))
+    if (!m_send_cmd(path, C37118_CMD_SEND_CONFIGURATION_2))
+        return false;
+    if (m_read_frame_of_type(path, C37118_FRAME_TYPE_CONFIGURATION_2, &frame, &size))
     {
-        int size = read(m_sockfd, buffer_rx, BUFFER_SIZE);
-        if (size > 0)
-        {
-            m_init_c37118();
-            m_config_frame->unpack(buffer_rx);
-            m_c37118_configuration_ready = true;
-            Logger::getLogger()->info("c37.118 configuration retrieved");
-        }
-        else
-        {
-            Logger::getLogger()->error("could not retrieve c37.118 configuration");
-            return;
-        }
+        std::lock_guard<std::mutex> lock(m_process_mutex);
+        m_install_config_frame(frame, size, path->arrival_ns);
+        Logger::getLogger()->info("c37.118 configuration retrieved");
+        return true;
     }
+    Logger::getLogger()->error("could not retrieve c37.118 configuration");
+    return false;
+}
+
+/**
+ * @brief replace the current c37.118 configuration by a configuration frame, unless they only differ by their timestamp:
+ * the redundant paths and the reconnections send the same configuration, which shall not reset the analysis stages
+ */
+void FC37118::m_install_config_frame(unsigned char *frame, size_t size, uint64_t arrival_ns)
+{
+    // SOC and FRACSEC (bytes 6 to 13) and CHK are not compared
+    if (m_c37118_configuration_ready && m_config_frame_raw.size() == size &&
+        std::equal(frame, frame + 6, m_config_frame_raw.begin()) &&
+        std::equal(frame + 14, frame + size - 2, m_config_frame_raw.begin() + 14))
+        return;
+
+    m_capture_frame(frame, size, arrival_ns);
+    m_init_c37118();
+    m_config_frame->unpack(frame);
+    m_config_frame_raw.assign(frame, frame + size);
+    m_server.set_config_frame(frame, size);
+    m_redundancy.set_time_base(m_config_frame->TIME_BASE_get());
+    m_c37118_configuration_ready = true;
+    m_log_configuration();
+    if (m_conf->is_dictionary_labels())
+        m_publish_dictionary();
 }
 
-bool FC37118::m_init_receiving()
+/**
+ * @brief install the SENDER_HARD_CONFIG configuration as a new c37.118 configuration
+ */
+void FC37118::m_install_hard_config()
 {
-    if (!m_connect())
+    m_init_c37118();
+    m_conf->to_conf_frame(m_config_frame);
+    m_redundancy.set_time_base(m_config_frame->TIME_BASE_get());
+    if (m_server.is_enabled() || m_archive.is_enabled())
+    {
+        unsigned char *config_frame_tx;
+        unsigned short size = m_config_frame->pack(&config_frame_tx);
+        m_server.set_config_frame(config_frame_tx, size);
+        m_archive.set_config_frame(config_frame_tx, size);
+    }
+
+    m_c37118_configuration_ready = true;
+
+    m_log_configuration();
+}
+
+bool FC37118::m_init_receiving(FC37118Path *path)
+{
+    if (!m_connect(path))
     {
         return false;
     }
 
-    if (m_conf->is_request_config_to_pmu())
+    if (m_conf->is_request_config_to_pmu() && !m_init_Pmu_Dialog(path))
     {
-        m_init_Pmu_Dialog();
+        return false;
     }
 
     if (!m_c37118_configuration_ready || m_terminate())
@@ -233,9 +414,7 @@ bool FC37118::m_init_receiving()
         return false;
     }
 
-    m_log_configuration();
-
-    return m_send_cmd(C37118_CMD_TURNON_TX);
+    return m_send_cmd(path, C37118_CMD_TURNON_TX);
 }
 
 /**
@@ -291,37 +470,62 @@ void FC37118::m_log_configuration()
 /**
  * @brief Receive the real time data from the c37.118 equipment. Leaves once  Wait for the configuration to be ready before requesting data.
  */
-void FC37118::m_receiveAndPushDatapoints()
+void FC37118::m_receiveAndPushDatapoints(FC37118Path *path)
 {
-    unsigned char buffer_rx[BUFFER_SIZE];
-    int size;
-    int k;
+    unsigned char *frame;
+    size_t size;
     bool init_ok = false;
 
+    m_low_latency.apply_thread();
+
+    if (m_conf->is_replay())
+    {
+        m_replay(path);
+        Logger::getLogger()->debug("Replay over: stop receiving");
+        return;
+    }
+
     while (!m_terminate())
     {
         while (!init_ok && !m_terminate())
         {
-            init_ok = m_init_receiving();
+            init_ok = m_init_receiving(path);
             if (init_ok)
-                Logger::getLogger()->debug("Connection and configuration OK, ready to receive real time data");
+                Logger::getLogger()->debug("Connection and configuration OK, ready to receive real time data from " + path->name);
         }
         if (m_terminate())
             break;
 
-        size = read(m_sockfd, buffer_rx, BUFFER_SIZE);
-        if (size > 0)
+        if (m_read_frame(path, &frame, &size) > 0)
         {
-            m_data_frame->unpack(buffer_rx);
-            for (auto reading : m_dataframe_to_reading())
+            // a configuration frame sent mid-stream describes the data frames that follow
+            if (frame_type(frame) == C37118_FRAME_TYPE_CONFIGURATION_2 && m_conf->is_request_config_to_pmu())
+            {
+                std::lock_guard<std::mutex> lock(m_process_mutex);
+                m_install_config_frame(frame, size, path->arrival_ns);
+                continue;
+            }
+            if (frame_type(frame) != C37118_FRAME_TYPE_DATA)
+                continue;
+            std::lock_guard<std::mutex> lock(m_process_mutex);
+            if (m_redundancy.is_enabled() && !m_redundancy.first_arrival(path->index, frame, path->arrival_ns))
+                continue;
+            m_capture_frame(frame, size, path->arrival_ns);
+            if (m_check_data_frame(path, size))
+                m_process_data_frame(frame, size, path->arrival_ns);
+            else if (path->nb_consecutive_size_errors >= DESYNC_SIZE_ERRORS && m_conf->is_request_config_to_pmu())
             {
-                ingest(*reading);
-                delete reading;
+                // the PMU configuration changed without sending it: reconnect to request it again
+                Logger::getLogger()->warn("%u consecutive data frames from %s do not match the configuration, reconnect",
+                                          DESYNC_SIZE_ERRORS, path->name.c_str());
+                path->nb_consecutive_size_errors = 0;
+                m_disconnect(path);
+                init_ok = false;
             }
         }
         else
         {
-            Logger::getLogger()->info("Connection lost, reconnect");
+            Logger::getLogger()->info("Connection lost with " + path->name + ", reconnect");
             init_ok = false;
         }
     }
@@ -329,53 +533,342 @@ void FC37118::m_receiveAndPushDatapoints()
 }
 
 /**
- * Save the callback function and its data
- * @param data   The Ingest function data
- * @param cb     The callback function to call
+ * @brief Read from the PMU connection until a complete frame with a valid CHK is reassembled.
+ * Frames split over several reads or sharing a read are handled, corrupt bytes are skipped up to the next SYNC word.
+ *
+ * @param frame set to the frame, valid until the next call
+ * @param size set to the frame size
+ * @return the frame size, 0 or less if the connection is lost
  */
-void FC37118::register_ingest(void *data, INGEST_CB cb)
+int FC37118::m_read_frame(FC37118Path *path, unsigned char **frame, size_t *size)
 {
-    m_ingest = cb;
-    m_data = data;
+    unsigned long nb_crc_errors = path->frame_reader.get_nb_crc_errors();
+    while (!path->frame_reader.next(frame, size))
+    {
+        if (path->frame_reader.get_nb_crc_errors() != nb_crc_errors)
+            m_report_frame_errors(path);
+        if (path->uring.is_open())
+        {
+            // the previous buffer is fully decoded (a split frame was copied by the reader)
+            path->uring.release();
+            unsigned char *data;
+            int n = path->uring.receive(&data);
+            path->arrival_ns = capture_clock_ns();
+            if (n > 0)
+            {
+                FC37118_PROBE2(read, path->index, n);
+                path->frame_reader.feed(data, n);
+                continue;
+            }
+            if (n == 0 || path->uring.is_open() || errno != EOPNOTSUPP)
+                return n;
+        }
+        int n = m_receive(path, path->frame_reader.write_ptr(), path->frame_reader.write_space());
+        if (n <= 0)
+            return n;
+        FC37118_PROBE2(read, path->index, n);
+        path->frame_reader.commit(n);
+    }
+    if (path->frame_reader.get_nb_crc_errors() != nb_crc_errors)
+        m_report_frame_errors(path);
+    FC37118_PROBE3(frame, path->index, frame_type(*frame), *size);
+    return *size;
 }
 
 /**
- * Called when a data changed event is received. This calls back to the south service
- * and adds the points to the readings queue to send.
+ * @brief Read frames until one of the given type, as data frames may still be flowing during the dialog
  *
- * @param points    The points in the reading we must create
+ * @return true - the frame was received
+ * @return false - the connection was lost or no such frame came in DIALOG_MAX_FRAMES frames
  */
-void FC37118::ingest(Reading &reading)
+bool FC37118::m_read_frame_of_type(FC37118Path *path, int type, unsigned char **frame, size_t *size)
 {
-    (*m_ingest)(m_data, reading);
+    for (int i = 0; i < DIALOG_MAX_FRAMES; i++)
+    {
+        if (m_read_frame(path, frame, size) <= 0)
+            return false;
+        if (frame_type(*frame) == type)
+            return true;
+    }
+    return false;
 }
 
-template <typename T>
-Datapoint *create_dp(const std::string &name, const T &value)
+/**
+ * @brief check the size of a data frame against the current c37.118 configuration, so that a frame
+ * sent with another configuration is never unpacked
+ */
+bool FC37118::m_check_data_frame(FC37118Path *path, size_t size)
 {
-    auto dpv = DatapointValue(value);
-    return new Datapoint(name, dpv);
+    if (m_expected_size_version != m_config_version)
+    {
+        m_expected_data_frame_size = expected_data_frame_size(m_config_frame);
+        m_expected_size_version = m_config_version;
+    }
+    if (size == m_expected_data_frame_size)
+    {
+        path->nb_consecutive_size_errors = 0;
+        return true;
+    }
+    path->nb_size_errors++;
+    path->nb_consecutive_size_errors++;
+    m_report_frame_errors(path);
+    return false;
 }
 
-Datapoint *create_dp_bool(const std::string &name, const bool &value)
+/**
+ * @brief log the discarded frame counters, at most every FRAME_ERROR_REPORT_PERIOD_S
+ */
+void FC37118::m_report_frame_errors(FC37118Path *path)
 {
-    auto dpv = DatapointValue(value ? "true" : "false");
-    return new Datapoint(name, dpv);
+    auto now = std::chrono::steady_clock::now();
+    unsigned long nb_errors = path->frame_reader.get_nb_crc_errors() + path->nb_size_errors;
+    if (nb_errors == path->reported_frame_errors ||
+        (path->reported_frame_errors > 0 && now - path->last_frame_error_report < std::chrono::seconds(FRAME_ERROR_REPORT_PERIOD_S)))
+        return;
+    Logger::getLogger()->warn("Frames discarded from %s: %lu with a bad CHK, %lu data frames with a size not matching the configuration (%lu bytes expected), %lu bytes skipped to resynchronise",
+                              path->name.c_str(), path->frame_reader.get_nb_crc_errors(), path->nb_size_errors, (unsigned long)m_expected_data_frame_size, path->frame_reader.get_nb_skipped_bytes());
+    path->reported_frame_errors = nb_errors;
+    path->last_frame_error_report = now;
 }
 
 /**
- * @brief Create a composed data point object
+ * @brief decode a raw data frame and ingest the resulting readings
  *
- * @param name
- * @param dps a Datapoint vector
- * @param is_dict true: is a dict, false: is a list
- * @return Datapoint*
+ * @param buffer the raw c37.118 data frame
+ * @param size size of the frame
+ * @param arrival_ns arrival time of the frame, for the lane latencies
  */
-Datapoint *create_dp_list(const std::string &name, std::vector<Datapoint *> *dps, bool is_dict)
+void FC37118::m_process_data_frame(unsigned char *buffer, size_t size, uint64_t arrival_ns)
 {
-    auto dpv = DatapointValue(dps, is_dict);
+    auto start = std::chrono::steady_clock::now();
+    if (m_server.is_running())
+        m_server.forward(buffer, size);
+    FC37118_PROBE1(unpack_start, size);
+    m_data_frame->unpack(buffer);
+    FC37118_PROBE2(unpack_done, m_data_frame->SOC_get(), m_data_frame->FRACSEC_get());
+    double fraction = m_frame_fraction();
+    double frame_time = m_data_frame->SOC_get() + fraction;
+    if (m_shm.is_open())
+        m_shm.publish(m_config_frame, m_config_version, m_conf->get_stn_idcodes_filter(),
+                      m_data_frame->SOC_get(), m_data_frame->FRACSEC_get(), frame_time);
+    if (m_derived.is_enabled())
+        m_derived.compute(m_config_frame, m_config_version, frame_time);
+    if (m_validation.is_enabled())
+        m_validation.evaluate(m_config_frame, m_config_version, frame_time);
+    if (m_trigger.is_enabled() && !m_chunker.is_enabled())
+        m_trigger.evaluate(m_config_frame, m_config_version, frame_time);
+    bool is_flagged = m_fast_lane.is_enabled() && m_fast_lane.classify(m_config_frame, m_conf->get_stn_idcodes_filter());
+    bool is_output = !m_load_shedding.is_enabled() || m_load_shedding.is_output_frame() || is_flagged;
+
+    // with chunks, the flagged stations of a frame are not chunked: only their readings are built, for the fast lane
+    std::vector<FC37118Reading> output;
+    if (is_output && m_chunker.is_enabled())
+    {
+        m_chunker.append(m_config_frame, m_config_version, m_conf->get_stn_idcodes_filter(), m_data_frame->SOC_get(), fraction,
+                         m_validation.is_enabled() ? &m_validation : nullptr, output,
+                         is_flagged ? &m_fast_lane.get_flagged_stations() : nullptr);
+        if (is_flagged)
+        {
+            for (auto reading : m_dataframe_to_reading(true))
+            {
+                reading.arrival_ns = arrival_ns;
+                m_ingest_reading(reading, FC37118Lane::FAST);
+                delete reading.reading;
+            }
+        }
+    }
+    else if (is_output)
+    {
+        for (auto reading : m_dataframe_to_reading())
+        {
+            reading.arrival_ns = arrival_ns;
+            if (is_flagged && m_fast_lane.is_flagged(reading.idcode))
+            {
+                m_ingest_reading(reading, FC37118Lane::FAST);
+                delete reading.reading;
+            }
+            else if (m_trigger.is_enabled() && !m_chunker.is_enabled())
+                m_trigger.filter(reading, frame_time, output);
+            else
+                output.push_back(reading);
+        }
+    }
+    for (auto &reading : output)
+        m_push(reading);
+
+    if (m_oscillation.is_enabled())
+    {
+        auto oscillation_reading = m_oscillation.update(m_config_frame, m_config_version, frame_time);
+        if (oscillation_reading != nullptr)
+            m_push({m_config_frame->IDCODE_get(), oscillation_reading, arrival_ns});
+    }
+
+    if (m_angle_difference.is_enabled())
+    {
+        auto angle_difference_reading = m_angle_difference.update(m_config_frame, m_config_version,
+                                                                  m_data_frame->SOC_get(), get_frac_sec_value(m_data_frame->FRACSEC_get()));
+        if (angle_difference_reading != nullptr)
+            m_push({m_config_frame->IDCODE_get(), angle_difference_reading, arrival_ns});
+    }
+
+    if (m_load_shedding.is_enabled())
+    {
+        auto load_shedding_reading = m_load_shedding.frame_done(m_config_frame, m_config_version, is_output, std::chrono::steady_clock::now() - start);
+        // the level change happens under overload, when the ingest queue is the most likely to drop: it is not queued
+        if (load_shedding_reading != nullptr)
+        {
+            m_ingest_reading({m_config_frame->IDCODE_get(), load_shedding_reading, arrival_ns}, FC37118Lane::FAST);
+            delete load_shedding_reading;
+        }
+    }
+
+    if (m_soak.is_enabled())
+        m_soak.frame();
+    FC37118_PROBE2(frame_done, m_data_frame->SOC_get(), m_data_frame->FRACSEC_get());
+}
 
-    return new Datapoint(name, dpv);
+/**
+ * @brief ingest a reading, through the ingest queue if enabled. Takes the ownership of the reading
+ */
+void FC37118::m_push(const FC37118Reading &reading)
+{
+    if (m_ingest_queue.is_running())
+    {
+        m_ingest_queue.push(reading);
+        return;
+    }
+    m_ingest_reading(reading, FC37118Lane::BULK);
+    delete reading.reading;
+}
+
+/**
+ * @brief ingest a reading and account for its latency on lane. The reading is not deleted
+ */
+void FC37118::m_ingest_reading(const FC37118Reading &reading, FC37118Lane lane)
+{
+    ingest(*reading.reading);
+    if (m_fast_lane.is_enabled())
+        m_fast_lane.record(lane, reading.arrival_ns);
+}
+
+void FC37118::m_capture_frame(const unsigned char *buffer, int size, uint64_t arrival_ns)
+{
+    if (m_capture.is_open())
+        m_capture.write(arrival_ns, buffer, size);
+    if (m_archive.is_open())
+        m_archive.write(arrival_ns, buffer, size);
+}
+
+/**
+ * @brief Feed the frames of the REPLAY capture file into the decode and ingest path, in place of the PMU connection.
+ * Configuration frames found in the capture replace the current c37.118 configuration.
+ * If REALTIME is set the original inter-arrival times are reproduced, otherwise the frames are replayed as fast as possible.
+ */
+void FC37118::m_replay(FC37118Path *path)
+{
+    unsigned char *frame;
+    size_t frame_size;
+    uint64_t arrival_ns, first_arrival_ns = 0;
+    uint32_t size;
+    unsigned long count = 0, loop_count = 0;
+    bool missing_config_logged = false;
+    FC37118CaptureReader reader;
+
+    if (!reader.open(m_conf->get_replay_file()))
+        return;
+    Logger::getLogger()->info("Replaying " + m_conf->get_replay_file());
+
+    path->frame_reader.reset();
+    auto start = std::chrono::steady_clock::now();
+    for (uint loop = 1; !m_terminate(); loop++)
+    {
+        while (!m_terminate() && reader.next(&arrival_ns, path->frame_reader.write_ptr(), path->frame_reader.write_space(), &size))
+        {
+            count++;
+            if (loop_count++ == 0)
+                first_arrival_ns = arrival_ns;
+
+            if (m_conf->is_replay_realtime())
+            {
+                auto due = start + std::chrono::nanoseconds(arrival_ns - first_arrival_ns);
+                while (!m_terminate() && std::chrono::steady_clock::now() < due)
+                    std::this_thread::sleep_until(std::min(due, std::chrono::steady_clock::now() + std::chrono::milliseconds(REPLAY_SLEEP_SLICE_MS)));
+            }
+
+            FC37118_PROBE2(read, path->index, size);
+            path->arrival_ns = capture_clock_ns();
+            path->frame_reader.commit(size);
+            unsigned long nb_crc_errors = path->frame_reader.get_nb_crc_errors();
+            while (path->frame_reader.next(&frame, &frame_size))
+            {
+                FC37118_PROBE3(frame, path->index, frame_type(frame), frame_size);
+                m_process_replayed_frame(path, frame, frame_size, &missing_config_logged);
+            }
+            if (path->frame_reader.get_nb_crc_errors() != nb_crc_errors)
+                m_report_frame_errors(path);
+        }
+        if ((m_conf->get_replay_loops() != 0 && loop >= m_conf->get_replay_loops()) || m_terminate() || !reader.rewind())
+            break;
+
+        // each loop is handled as a reconnection followed by a reconfiguration
+        Logger::getLogger()->debug("Replay loop %u finished", loop);
+        path->frame_reader.reset();
+        m_config_frame_raw.clear();
+        if (!m_conf->is_request_config_to_pmu())
+            m_install_hard_config();
+        loop_count = 0;
+        start = std::chrono::steady_clock::now();
+    }
+    Logger::getLogger()->info("Replay finished: %lu frames replayed", count);
+}
+
+void FC37118::m_process_replayed_frame(FC37118Path *path, unsigned char *frame, size_t size, bool *missing_config_logged)
+{
+    switch (frame_type(frame))
+    {
+    case C37118_FRAME_TYPE_CONFIGURATION_1:
+    case C37118_FRAME_TYPE_CONFIGURATION_2:
+        m_install_config_frame(frame, size, path->arrival_ns);
+        break;
+    case C37118_FRAME_TYPE_DATA:
+        if (!m_c37118_configuration_ready)
+        {
+            if (!*missing_config_logged)
+            {
+                Logger::getLogger()->warn("Data frames replayed before any configuration are ignored");
+                *missing_config_logged = true;
+            }
+        }
+        else if (m_check_data_frame(path, size))
+            m_process_data_frame(frame, size, path->arrival_ns);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * Save the callback function and its data
+ * @param data   The Ingest function data
+ * @param cb     The callback function to call
+ */
+void FC37118::register_ingest(void *data, INGEST_CB cb)
+{
+    m_ingest = cb;
+    m_data = data;
+}
+
+/**
+ * Called when a data changed event is received. This calls back to the south service
+ * and adds the points to the readings queue to send.
+ *
+ * @param points    The points in the reading we must create
+ */
+void FC37118::ingest(Reading &reading)
+{
+    FC37118_PROBE1(ingest_start, reading.getAssetName().c_str());
+    (*m_ingest)(m_data, reading);
+    FC37118_PROBE1(ingest_done, reading.getAssetName().c_str());
 }
 
 unsigned long get_frac_sec_value(unsigned long fracsec)
@@ -403,16 +896,28 @@ bool get_frac_sec_leap_quality_indication(unsigned long fracsec)
     return (fracsec << 8) & 0xff == 1;
 }
 
+/**
+ * @brief fraction of second of the last unpacked data frame
+ *
+ * @return double - FRACSEC / TIME_BASE, in seconds
+ */
+double FC37118::m_frame_fraction()
+{
+    return (double)get_frac_sec_value(m_data_frame->FRACSEC_get()) / m_config_frame->TIME_BASE_get();
+}
+
 /**
  * @brief transform the c37118 dataframe to fledge Reading
  *
- * @return Reading
+ * @param is_flagged_only only the stations flagged by the fast lane are converted
+ * @return the readings with the IDCODE they were built from
  */
 
-vector<Reading *> FC37118::m_dataframe_to_reading()
+vector<FC37118Reading> FC37118::m_dataframe_to_reading(bool is_flagged_only)
 {
+    FC37118_PROBE2(convert_start, m_data_frame->SOC_get(), m_data_frame->FRACSEC_get());
     auto v_filter = m_conf->get_stn_idcodes_filter();
-    std::vector<Reading *> readings;
+    std::vector<FC37118Reading> readings;
     auto dp_SOC = create_dp(DP_SOC, (long)(m_data_frame->SOC_get()));
     auto frac_sec = m_data_frame->FRACSEC_get();
     auto dp_FRACSEC = create_dp(DP_FRACSEC, (long)(get_frac_sec_value(frac_sec)));
@@ -424,22 +929,67 @@ vector<Reading *> FC37118::m_dataframe_to_reading()
     auto dp_ls = create_dp_list(DP_LS, new std::vector<Datapoint *>({dp_ls_direction, dp_ls_occurs, dp_ls_pending}), true);
     auto dp_time = create_dp_list(DP_TIMESTAMP, new std::vector<Datapoint *>({dp_SOC, dp_FRACSEC, dp_TIME_BASE, dp_time_quality, dp_ls}), true);
 
-    auto pmu_dps = new std::vector<Datapoint *>;
-    for (auto pmu_station : m_config_frame->pmu_station_list)
+    std::vector<PMU_Station *> pmu_stations;
+    std::vector<size_t> station_indexes;
+    for (size_t index = 0; index < m_config_frame->pmu_station_list.size(); index++)
     {
+        auto pmu_station = m_config_frame->pmu_station_list[index];
         if (!v_filter.empty())
         {
             Logger::getLogger()->debug("v_filter is not empty");
             if (std::find(v_filter.begin(), v_filter.end(), pmu_station->IDCODE_get()) == v_filter.end()) // IDCODE not found
                 continue;
         }
-        auto dp_pmu_station = m_pmu_station_to_datapoint(pmu_station);
+        if (is_flagged_only && m_fast_lane.get_flagged_stations().count(pmu_station->IDCODE_get()) == 0)
+            continue;
+        pmu_stations.push_back(pmu_station);
+        station_indexes.push_back(index);
+    }
+
+    // stations are converted in shards, each one writing to its own slots so that the order is kept
+    std::vector<Datapoint *> station_dps(pmu_stations.size());
+    const FC37118LoadLevelConf &level = m_load_shedding.get_level();
+    bool is_dictionary_labels = m_conf->is_dictionary_labels() || level.is_compact;
+    if (is_dictionary_labels && m_dictionary_config_version != m_config_version)
+        m_publish_dictionary();
+    auto convert = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            station_dps[i] = is_dictionary_labels ? m_pmu_station_to_indexed_datapoint(pmu_stations[i], station_indexes[i], level)
+                                                  : m_pmu_station_to_datapoint(pmu_stations[i], station_indexes[i], level);
+            if (m_derived.is_enabled())
+            {
+                auto dp_derived = m_derived.to_datapoint(station_indexes[i]);
+                if (dp_derived != nullptr)
+                    station_dps[i]->getData().getDpVec()->push_back(dp_derived);
+            }
+            if (m_validation.is_enabled())
+            {
+                auto dp_bad_data = m_validation.to_datapoint(station_indexes[i]);
+                if (dp_bad_data != nullptr)
+                    station_dps[i]->getData().getDpVec()->push_back(dp_bad_data);
+            }
+        }
+    };
+    if (m_conversion_pool.is_running() && pmu_stations.size() >= m_conf->get_parallel_conf()->get_min_stations())
+        m_conversion_pool.run(pmu_stations.size(), convert);
+    else
+        convert(0, pmu_stations.size());
+
+    auto pmu_dps = new std::vector<Datapoint *>;
+    for (size_t i = 0; i < pmu_stations.size(); i++)
+    {
+        auto dp_pmu_station = station_dps[i];
         if (m_conf->is_split_stations())
         {
-            auto dp_reading = create_dp_list(DP_SINGLE_PMU, new std::vector<Datapoint *>({new Datapoint(*dp_time), dp_pmu_station}), true);
-            readings.push_back(
-                new Reading(to_string(m_config_frame->IDCODE_get()) + "-" + to_string(pmu_station->IDCODE_get()),
-                            dp_reading));
+            auto dps = new std::vector<Datapoint *>({new Datapoint(*dp_time), dp_pmu_station});
+            if (is_dictionary_labels)
+                dps->insert(dps->begin() + 1, create_dp(DP_CONFIG_VERSION, m_dictionary.get_version()));
+            auto dp_reading = create_dp_list(DP_SINGLE_PMU, dps, true);
+            readings.push_back({pmu_stations[i]->IDCODE_get(),
+                                new Reading(to_string(m_config_frame->IDCODE_get()) + "-" + to_string(pmu_stations[i]->IDCODE_get()),
+                                            dp_reading)});
         }
         else
             pmu_dps->push_back(dp_pmu_station);
@@ -453,10 +1003,14 @@ vector<Reading *> FC37118::m_dataframe_to_reading()
     else
     {
         auto dp_pmu_stations = create_dp_list(DP_PMUSTATIONS, pmu_dps, false);
-        auto dp_reading = create_dp_list(DP_MULTI_PMU, new std::vector<Datapoint *>({dp_time, dp_pmu_stations}), true);
-        readings.push_back(new Reading(to_string(m_config_frame->IDCODE_get()), dp_reading));
+        auto dps = new std::vector<Datapoint *>({dp_time, dp_pmu_stations});
+        if (is_dictionary_labels)
+            dps->insert(dps->begin() + 1, create_dp(DP_CONFIG_VERSION, m_dictionary.get_version()));
+        auto dp_reading = create_dp_list(DP_MULTI_PMU, dps, true);
+        readings.push_back({m_config_frame->IDCODE_get(), new Reading(to_string(m_config_frame->IDCODE_get()), dp_reading)});
     }
 
+    FC37118_PROBE3(convert_done, m_data_frame->SOC_get(), m_data_frame->FRACSEC_get(), readings.size());
     return readings;
 }
 
@@ -470,8 +1024,22 @@ bool get_stat_sync(unsigned short stat)
     return ((stat << 3) & 1) == 0;
 }
 
-Datapoint *FC37118::m_pmu_station_to_datapoint(PMU_Station *pmu_station)
+/**
+ * @brief number of channels output out of nb, max being -1 for all
+ */
+static int nb_output_channels(int nb, int max)
 {
+    return max < 0 ? nb : std::min(nb, max);
+}
+
+Datapoint *FC37118::m_pmu_station_to_datapoint(PMU_Station *pmu_station, size_t index, const FC37118LoadLevelConf &level)
+{
+    FC37118_PROBE1(station_start, pmu_station->IDCODE_get());
+    // VALIDATION SUPPRESS mode: the flagged values are left out, FREQ and DFREQ coming first then each phasor magnitude
+    // and angle, then the analogs
+    const uint8_t *bad_flags = m_validation.is_enabled() && m_validation.is_suppress() ? m_validation.get_flags(index) : nullptr;
+    auto is_bad = [bad_flags](int channel)
+    { return bad_flags != nullptr && bad_flags[channel] != 0; };
     auto dp_IDCODE = create_dp(DP_IDCODE, (double)(pmu_station->IDCODE_get()));
     auto dp_STN = create_dp(DP_STN, pmu_station->STN_get());
     auto stat = pmu_station->STAT_get();
@@ -479,13 +1047,18 @@ Datapoint *FC37118::m_pmu_station_to_datapoint(PMU_Station *pmu_station)
     auto dp_sync = create_dp_bool(DP_TIME_SYNC, get_stat_sync(stat));
     auto dp_id = create_dp_list(DP_ID, new std::vector<Datapoint *>({dp_STN, dp_IDCODE, dp_quality, dp_sync}), true);
 
-    auto dp_FREQ = create_dp(DP_FREQ, pmu_station->FREQ_get());
-    auto dp_DFREQ = create_dp(DP_DFREQ, pmu_station->DFREQ_get());
-    auto dp_frequency = create_dp_list(DP_FREQUENCY, new std::vector<Datapoint *>({dp_FREQ, dp_DFREQ}), true);
+    auto frequency_dps = new std::vector<Datapoint *>;
+    if (!is_bad(0))
+        frequency_dps->push_back(create_dp(DP_FREQ, pmu_station->FREQ_get()));
+    if (!is_bad(1))
+        frequency_dps->push_back(create_dp(DP_DFREQ, pmu_station->DFREQ_get()));
+    auto dp_frequency = create_dp_list(DP_FREQUENCY, frequency_dps, true);
 
     auto phasor_dps = new std::vector<Datapoint *>;
-    for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+    for (int k = 0; k < nb_output_channels(pmu_station->PHNMR_get(), level.max_phasors); k++)
     {
+        if (is_bad(2 + 2 * k) || is_bad(3 + 2 * k))
+            continue;
         auto dp_mag = create_dp(DP_MAGNITUDE, abs(pmu_station->PHASOR_VALUE_get(k)));
         auto dp_angle = create_dp(DP_ANGLE, arg(pmu_station->PHASOR_VALUE_get(k)));
         auto dp_val = create_dp_list(DP_VALUE, new std::vector<Datapoint *>({dp_mag, dp_angle}), true);
@@ -497,13 +1070,72 @@ Datapoint *FC37118::m_pmu_station_to_datapoint(PMU_Station *pmu_station)
     auto test = pmu_station->STAT_get();
 
     auto analog_dps = new std::vector<Datapoint *>;
-    for (int k = 0; k < pmu_station->ANNMR_get(); k++)
+    for (int k = 0; k < nb_output_channels(pmu_station->ANNMR_get(), level.max_analogs); k++)
     {
+        if (is_bad(2 + 2 * pmu_station->PHNMR_get() + k))
+            continue;
         auto dp_label = create_dp(DP_LABEL, pmu_station->AN_NAME_get(k));
         auto dp_an_value = create_dp(DP_VALUE, pmu_station->ANALOG_VALUE_get(k));
         auto dp_an = create_dp_list(DP_VALUE, new std::vector<Datapoint *>({dp_label, dp_an_value}), true);
         analog_dps->push_back(dp_an);
     }
     auto dp_analogs = create_dp_list(DP_ANALOGS, analog_dps, false);
+    FC37118_PROBE1(station_done, pmu_station->IDCODE_get());
     return create_dp_list(PMU_DATA, new std::vector<Datapoint *>({dp_id, dp_frequency, dp_phasors, dp_analogs}), true);
+}
+
+/**
+ * @brief DICTIONARY_LABELS form of the station datapoint: the station is referred to by its index in the configuration,
+ * the phasors and analogs are arrays in configuration order, their labels being in the dictionary reading
+ */
+Datapoint *FC37118::m_pmu_station_to_indexed_datapoint(PMU_Station *pmu_station, size_t index, const FC37118LoadLevelConf &level)
+{
+    FC37118_PROBE1(station_start, pmu_station->IDCODE_get());
+    // VALIDATION SUPPRESS mode: FREQ and DFREQ are left out when bad, the bad values are NaN in the arrays so that
+    // their positions still match the dictionary
+    const uint8_t *bad_flags = m_validation.is_enabled() && m_validation.is_suppress() ? m_validation.get_flags(index) : nullptr;
+    auto is_bad = [bad_flags](int channel)
+    { return bad_flags != nullptr && bad_flags[channel] != 0; };
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    auto stat = pmu_station->STAT_get();
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_STATION_INDEX, (long)index));
+    dps->push_back(create_dp_bool(DP_QUAL, get_stat_quality(stat)));
+    dps->push_back(create_dp_bool(DP_TIME_SYNC, get_stat_sync(stat)));
+    if (!is_bad(0))
+        dps->push_back(create_dp(DP_FREQ, pmu_station->FREQ_get()));
+    if (!is_bad(1))
+        dps->push_back(create_dp(DP_DFREQ, pmu_station->DFREQ_get()));
+
+    int nb_phasors = nb_output_channels(pmu_station->PHNMR_get(), level.max_phasors);
+    std::vector<double> magnitudes(nb_phasors), angles(nb_phasors), analogs(nb_output_channels(pmu_station->ANNMR_get(), level.max_analogs));
+    for (size_t k = 0; k < magnitudes.size(); k++)
+    {
+        auto phasor = pmu_station->PHASOR_VALUE_get(k);
+        bool is_bad_phasor = is_bad(2 + 2 * k) || is_bad(3 + 2 * k);
+        magnitudes[k] = is_bad_phasor ? nan : abs(phasor);
+        angles[k] = is_bad_phasor ? nan : arg(phasor);
+    }
+    for (size_t k = 0; k < analogs.size(); k++)
+        analogs[k] = is_bad(2 + 2 * pmu_station->PHNMR_get() + k) ? nan : pmu_station->ANALOG_VALUE_get(k);
+    dps->push_back(create_dp(DP_MAGNITUDE, magnitudes));
+    dps->push_back(create_dp(DP_ANGLE, angles));
+    dps->push_back(create_dp(DP_ANALOGS, analogs));
+    FC37118_PROBE1(station_done, pmu_station->IDCODE_get());
+    return create_dp_list(PMU_DATA, dps, true);
+}
+
+/**
+ * @brief ingest the dictionary of the current configuration, before the data readings that refer to it.
+ * The configuration frame is packed again, so that the version does not depend on how the configuration was obtained.
+ * The dictionary is not queued, so that the INGEST_QUEUE policy never drops it
+ */
+void FC37118::m_publish_dictionary()
+{
+    unsigned char *config_frame_tx;
+    unsigned short size = m_config_frame->pack(&config_frame_tx);
+    auto reading = m_dictionary.update(m_config_frame, config_frame_tx, size, m_conf->get_stn_idcodes_filter());
+    m_dictionary_config_version = m_config_version;
+    m_ingest_reading({m_config_frame->IDCODE_get(), reading, 0}, FC37118Lane::FAST);
+    delete reading;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cmath>
+
+#include "fc37118.h"
+#include "fc37118angle.h"
+#include "fc37118datapoint.h"
+
+#define RAD_TO_DEG (180.0 / M_PI)
+
+FC37118AngleDifference::FC37118AngleDifference() : m_conf(nullptr),
+                                                   m_config_version(0),
+                                                   m_nb_frames(0),
+                                                   m_stream_idcode(0)
+{
+}
+
+FC37118AngleDifference::~FC37118AngleDifference() {}
+
+void FC37118AngleDifference::configure(FC37118AngleDifferenceConf *conf)
+{
+    m_conf = conf;
+    m_config_version = 0;
+    m_pairs.clear();
+}
+
+bool FC37118AngleDifference::m_resolve(CONFIG_Frame *config_frame, const FC37118PhasorConf &phasor_conf, FC37118ChannelRef *ref)
+{
+    if (ref->resolve(config_frame, phasor_conf.idcode, phasor_conf.channel, true) && ref->kind == ChannelKind::PHASOR_ANGLE)
+        return true;
+    Logger::getLogger()->warn(ANGLE_DIFFERENCE ": phasor " + phasor_conf.channel + " of station %u not found", phasor_conf.idcode);
+    return false;
+}
+
+/**
+ * @brief resolve the phasors of the pairs, a pair is kept out while one of its phasors is missing
+ */
+void FC37118AngleDifference::m_setup(CONFIG_Frame *config_frame)
+{
+    m_pairs.clear();
+    for (auto &pair_conf : m_conf->get_pairs())
+    {
+        Pair pair;
+        pair.conf = pair_conf;
+        if (!m_resolve(config_frame, pair_conf.phasor, &pair.phasor) || !m_resolve(config_frame, pair_conf.reference, &pair.reference))
+            continue;
+        pair.difference_deg = 0;
+        pair.is_alarm = false;
+        m_pairs.push_back(pair);
+    }
+    m_stream_idcode = config_frame->IDCODE_get();
+    m_nb_frames = 0;
+    Logger::getLogger()->info(ANGLE_DIFFERENCE ": %u pairs", (uint)m_pairs.size());
+}
+
+/**
+ * @return true - the alarm of the pair was raised or cleared
+ */
+bool FC37118AngleDifference::m_update_alarm(Pair &pair)
+{
+    if (pair.conf.alarm_deg <= 0)
+        return false;
+    double difference = std::abs(pair.difference_deg);
+    if (!pair.is_alarm && difference > pair.conf.alarm_deg)
+    {
+        pair.is_alarm = true;
+        Logger::getLogger()->warn(ANGLE_DIFFERENCE ": " + pair.conf.name + " at %.2f deg, over %.2f deg", pair.difference_deg, pair.conf.alarm_deg);
+        return true;
+    }
+    if (pair.is_alarm && difference < pair.conf.alarm_deg - m_conf->get_hysteresis_deg())
+    {
+        pair.is_alarm = false;
+        Logger::getLogger()->info(ANGLE_DIFFERENCE ": " + pair.conf.name + " back to %.2f deg", pair.difference_deg);
+        return true;
+    }
+    return false;
+}
+
+Reading *FC37118AngleDifference::update(CONFIG_Frame *config_frame, unsigned long config_version, unsigned long soc, unsigned long fracsec)
+{
+    if (config_version != m_config_version)
+    {
+        m_setup(config_frame);
+        m_config_version = config_version;
+    }
+    if (m_pairs.empty())
+        return nullptr;
+
+    bool is_alarm_changed = false;
+    for (auto &pair : m_pairs)
+    {
+        auto phasor = config_frame->pmu_station_list[pair.phasor.station]->PHASOR_VALUE_get(pair.phasor.index);
+        auto reference = config_frame->pmu_station_list[pair.reference.station]->PHASOR_VALUE_get(pair.reference.index);
+        pair.difference_deg = std::arg(phasor * std::conj(reference)) * RAD_TO_DEG;
+        is_alarm_changed |= m_update_alarm(pair);
+    }
+    if (m_nb_frames++ % m_conf->get_decimation() != 0 && !is_alarm_changed)
+        return nullptr;
+
+    auto difference_dps = new std::vector<Datapoint *>;
+    auto alarm_dps = new std::vector<Datapoint *>;
+    for (auto &pair : m_pairs)
+    {
+        difference_dps->push_back(create_dp(pair.conf.name, pair.difference_deg));
+        if (pair.is_alarm)
+            alarm_dps->push_back(create_dp(DP_LABEL, pair.conf.name));
+    }
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_SOC, (long)soc));
+    dps->push_back(create_dp(DP_FRACSEC, (long)fracsec));
+    dps->push_back(create_dp_list(DP_DIFFERENCES, difference_dps, true));
+    if (alarm_dps->empty())
+        delete alarm_dps;
+    else
+        dps->push_back(create_dp_list(DP_ALARMS, alarm_dps, false));
+    return new Reading(std::to_string(m_stream_idcode) + "-" + DP_ANGLE_DIFFERENCE, create_dp_list(DP_ANGLE_DIFFERENCE, dps, true));
+}
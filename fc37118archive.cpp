@@ -0,0 +1,330 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "fc37118archive.h"
+
+#define ARCHIVE_FRAME_TYPE(frame) (((frame)[1] >> 4) & 0x07)
+#define ARCHIVE_IS_CONFIG_FRAME(frame) (ARCHIVE_FRAME_TYPE(frame) == 2 || ARCHIVE_FRAME_TYPE(frame) == 3)
+
+static bool ends_with(const std::string &s, const std::string &suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static uint64_t file_size(const std::string &path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+static std::string index_path(const std::string &segment_path)
+{
+    return segment_path.substr(0, segment_path.size() - strlen(ARCHIVE_SEGMENT_SUFFIX)) + ARCHIVE_INDEX_SUFFIX;
+}
+
+FC37118ArchiveWriter::FC37118ArchiveWriter() : m_conf(nullptr),
+                                               m_is_open(false),
+                                               m_is_compression(false),
+                                               m_total_size(0),
+                                               m_segment(nullptr),
+                                               m_index(nullptr),
+                                               m_segment_first_soc(0),
+                                               m_segment_size(0),
+                                               m_config_arrival_ns(0),
+                                               m_block_first_soc(0),
+                                               m_block_last_soc(0),
+                                               m_block_nb_frames(0),
+                                               m_missing_config_logged(false)
+{
+}
+
+FC37118ArchiveWriter::~FC37118ArchiveWriter()
+{
+    close();
+}
+
+void FC37118ArchiveWriter::configure(FC37118ArchiveConf *conf)
+{
+    close();
+    m_conf = conf;
+    m_config_frame.clear();
+}
+
+bool FC37118ArchiveWriter::open()
+{
+    close();
+    std::string directory = m_conf->get_directory();
+
+    // create the missing parents too
+    for (size_t pos = 0; pos != std::string::npos;)
+    {
+        pos = directory.find('/', pos + 1);
+        std::string parent = directory.substr(0, pos);
+        if (mkdir(parent.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            Logger::getLogger()->error("Archive: unable to create " + parent + ": " + strerror(errno));
+            return false;
+        }
+    }
+
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr)
+    {
+        Logger::getLogger()->error("Archive: unable to open " + directory + ": " + strerror(errno));
+        return false;
+    }
+    std::vector<std::string> names;
+    while (struct dirent *entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name.compare(0, strlen(ARCHIVE_FILE_PREFIX), ARCHIVE_FILE_PREFIX) == 0 && ends_with(name, ARCHIVE_SEGMENT_SUFFIX))
+            names.push_back(name);
+    }
+    closedir(dir);
+
+    // the first SOC is zero padded in the names: the alphabetical order is the chronological order
+    std::sort(names.begin(), names.end());
+    m_segments.clear();
+    m_total_size = 0;
+    for (auto &name : names)
+    {
+        std::string path = directory + "/" + name;
+        Segment segment{path, file_size(path) + file_size(index_path(path))};
+        m_segments.push_back(segment);
+        m_total_size += segment.size;
+    }
+
+    m_is_compression = m_conf->is_compression();
+#ifndef HAVE_ZLIB
+    if (m_is_compression)
+    {
+        Logger::getLogger()->warn("Archive: built without zlib, " ARC_COMPRESSION " " ARC_COMPRESSION_ZLIB " is ignored");
+        m_is_compression = false;
+    }
+#endif
+    m_block.reserve(m_conf->get_block_size() + 64 * 1024);
+    m_missing_config_logged = false;
+    m_is_open = true;
+    Logger::getLogger()->info("Archive: archiving raw frames to %s, %lu segments, %lu MB already archived",
+                              directory.c_str(), (unsigned long)m_segments.size(), (unsigned long)(m_total_size >> 20));
+    m_enforce_max_size();
+    return true;
+}
+
+void FC37118ArchiveWriter::close()
+{
+    if (!m_is_open)
+        return;
+    m_close_segment();
+    m_is_open = false;
+}
+
+void FC37118ArchiveWriter::set_config_frame(const unsigned char *frame, size_t size)
+{
+    m_config_frame.assign(frame, frame + size);
+    m_config_arrival_ns = 0;
+    // the data frames to come belong to the new configuration
+    if (m_is_open)
+        m_close_segment();
+}
+
+void FC37118ArchiveWriter::write(uint64_t arrival_ns, const unsigned char *frame, uint32_t size)
+{
+    if (!m_is_open)
+        return;
+    if (ARCHIVE_IS_CONFIG_FRAME(frame))
+    {
+        set_config_frame(frame, size);
+        m_config_arrival_ns = arrival_ns;
+        return;
+    }
+    if (m_config_frame.empty())
+    {
+        if (!m_missing_config_logged)
+            Logger::getLogger()->warn("Archive: frames received before any configuration frame are not archived");
+        m_missing_config_logged = true;
+        return;
+    }
+
+    uint32_t soc = archive_frame_soc(frame);
+    if (m_segment != nullptr &&
+        (m_segment_size + m_block.size() >= m_conf->get_segment_size() || soc >= m_segment_first_soc + m_conf->get_segment_s()))
+        m_close_segment();
+    if (m_segment == nullptr)
+    {
+        if (!m_open_segment(soc, arrival_ns))
+            return;
+    }
+    else if (m_block_nb_frames > 0 &&
+             (m_block.size() + ARCHIVE_RECORD_HEADER_SIZE + size > m_conf->get_block_size() ||
+              soc >= m_block_first_soc + m_conf->get_index_period_s()))
+    {
+        if (!m_write_block())
+            return;
+    }
+    m_append(arrival_ns, frame, size);
+    m_block_first_soc = m_block_nb_frames == 0 ? soc : std::min(m_block_first_soc, soc);
+    m_block_last_soc = m_block_nb_frames == 0 ? soc : std::max(m_block_last_soc, soc);
+    m_block_nb_frames++;
+}
+
+/**
+ * @brief start a segment with the current configuration frame, the SOC range of the first block is the one of its data frames
+ */
+bool FC37118ArchiveWriter::m_open_segment(uint32_t soc, uint64_t arrival_ns)
+{
+    char name[64];
+    std::string path;
+    for (int n = 0; path.empty() || access(path.c_str(), F_OK) == 0; n++)
+    {
+        if (n == 0)
+            snprintf(name, sizeof(name), ARCHIVE_FILE_PREFIX "%010u" ARCHIVE_SEGMENT_SUFFIX, soc);
+        else
+            snprintf(name, sizeof(name), ARCHIVE_FILE_PREFIX "%010u_%d" ARCHIVE_SEGMENT_SUFFIX, soc, n);
+        path = m_conf->get_directory() + "/" + name;
+    }
+    m_segment = fopen(path.c_str(), "wb");
+    m_index = m_segment == nullptr ? nullptr : fopen(index_path(path).c_str(), "wb");
+    if (m_segment == nullptr || m_index == nullptr ||
+        fwrite(ARCHIVE_SEGMENT_MAGIC, 1, ARCHIVE_MAGIC_SIZE, m_segment) != ARCHIVE_MAGIC_SIZE ||
+        fwrite(ARCHIVE_INDEX_MAGIC, 1, ARCHIVE_MAGIC_SIZE, m_index) != ARCHIVE_MAGIC_SIZE)
+    {
+        m_fail("unable to create " + path + ": " + strerror(errno));
+        return false;
+    }
+    m_segments.push_back(Segment{path, 2 * ARCHIVE_MAGIC_SIZE});
+    m_total_size += 2 * ARCHIVE_MAGIC_SIZE;
+    m_segment_first_soc = soc;
+    m_segment_size = ARCHIVE_MAGIC_SIZE;
+
+    m_block.clear();
+    m_block_nb_frames = 0;
+    m_append(m_config_arrival_ns != 0 ? m_config_arrival_ns : arrival_ns, m_config_frame.data(), m_config_frame.size());
+    Logger::getLogger()->debug("Archive: new segment " + path);
+    return true;
+}
+
+void FC37118ArchiveWriter::m_close_segment()
+{
+    if (m_segment == nullptr)
+        return;
+    if (m_block_nb_frames > 0)
+        m_write_block();
+    if (m_segment != nullptr)
+        fclose(m_segment);
+    if (m_index != nullptr)
+        fclose(m_index);
+    m_segment = nullptr;
+    m_index = nullptr;
+    m_block.clear();
+    m_block_nb_frames = 0;
+}
+
+/**
+ * @brief write the current block and its index entry, flushed so that the extractor sees whole blocks only
+ */
+bool FC37118ArchiveWriter::m_write_block()
+{
+    FC37118ArchiveBlockHeader header;
+    header.first_soc = m_block_first_soc;
+    header.last_soc = m_block_last_soc;
+    header.nb_frames = m_block_nb_frames;
+    header.compression = ARCHIVE_COMPRESSION_NONE;
+    header.raw_size = m_block.size();
+    header.stored_size = m_block.size();
+    const unsigned char *stored = m_block.data();
+#ifdef HAVE_ZLIB
+    if (m_is_compression)
+    {
+        uLongf stored_size = compressBound(m_block.size());
+        m_stored.resize(stored_size);
+        // kept when it actually saves space only
+        if (compress2(m_stored.data(), &stored_size, m_block.data(), m_block.size(), Z_BEST_SPEED) == Z_OK &&
+            stored_size < m_block.size())
+        {
+            header.compression = ARCHIVE_COMPRESSION_ZLIB;
+            header.stored_size = stored_size;
+            stored = m_stored.data();
+        }
+    }
+#endif
+    FC37118ArchiveIndexEntry entry{m_block_first_soc, m_block_last_soc, m_segment_size};
+    if (fwrite(&header, sizeof(header), 1, m_segment) != 1 ||
+        fwrite(stored, 1, header.stored_size, m_segment) != header.stored_size ||
+        fflush(m_segment) != 0 ||
+        fwrite(&entry, sizeof(entry), 1, m_index) != 1 ||
+        fflush(m_index) != 0)
+    {
+        m_fail(std::string("write failed: ") + strerror(errno));
+        return false;
+    }
+    uint64_t written = sizeof(header) + header.stored_size + sizeof(entry);
+    m_segment_size += sizeof(header) + header.stored_size;
+    m_segments.back().size += written;
+    m_total_size += written;
+    m_block.clear();
+    m_block_nb_frames = 0;
+    m_enforce_max_size();
+    return true;
+}
+
+void FC37118ArchiveWriter::m_append(uint64_t arrival_ns, const unsigned char *frame, uint32_t size)
+{
+    const unsigned char *arrival = (const unsigned char *)&arrival_ns;
+    const unsigned char *frame_size = (const unsigned char *)&size;
+    m_block.insert(m_block.end(), arrival, arrival + sizeof(arrival_ns));
+    m_block.insert(m_block.end(), frame_size, frame_size + sizeof(size));
+    m_block.insert(m_block.end(), frame, frame + size);
+}
+
+/**
+ * @brief remove the oldest segments beyond MAX_SIZE_MB, never the one being written
+ */
+void FC37118ArchiveWriter::m_enforce_max_size()
+{
+    uint64_t max_size = m_conf->get_max_size();
+    if (max_size == 0)
+        return;
+    size_t nb_kept = m_segment != nullptr ? 1 : 0;
+    while (m_total_size > max_size && m_segments.size() > nb_kept)
+    {
+        Segment &oldest = m_segments.front();
+        if (unlink(oldest.path.c_str()) != 0 && errno != ENOENT)
+            Logger::getLogger()->warn("Archive: unable to remove " + oldest.path + ": " + strerror(errno));
+        unlink(index_path(oldest.path).c_str());
+        Logger::getLogger()->debug("Archive: removed " + oldest.path);
+        m_total_size -= std::min(m_total_size, oldest.size);
+        m_segments.pop_front();
+    }
+}
+
+void FC37118ArchiveWriter::m_fail(const std::string &message)
+{
+    Logger::getLogger()->error("Archive: " + message + ", archive stopped");
+    if (m_segment != nullptr)
+        fclose(m_segment);
+    if (m_index != nullptr)
+        fclose(m_index);
+    m_segment = nullptr;
+    m_index = nullptr;
+    m_block.clear();
+    m_block_nb_frames = 0;
+    m_is_open = false;
+}
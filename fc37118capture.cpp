@@ -0,0 +1,136 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cstring>
+#include <ctime>
+
+#include "logger.h"
+#include "fc37118capture.h"
+
+uint64_t capture_clock_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+FC37118CaptureWriter::FC37118CaptureWriter() : m_file(nullptr)
+{
+}
+
+FC37118CaptureWriter::~FC37118CaptureWriter()
+{
+    close();
+}
+
+bool FC37118CaptureWriter::open(const std::string &path)
+{
+    close();
+    m_file = fopen(path.c_str(), "wb");
+    if (m_file == nullptr)
+    {
+        Logger::getLogger()->error("Unable to open capture file " + path);
+        return false;
+    }
+    m_io_buffer.resize(CAPTURE_IO_BUFFER_SIZE);
+    setvbuf(m_file, m_io_buffer.data(), _IOFBF, m_io_buffer.size());
+    if (fwrite(CAPTURE_MAGIC, 1, CAPTURE_MAGIC_SIZE, m_file) != CAPTURE_MAGIC_SIZE)
+    {
+        Logger::getLogger()->error("Unable to write capture file " + path);
+        close();
+        return false;
+    }
+    Logger::getLogger()->info("Capturing raw frames to " + path);
+    return true;
+}
+
+void FC37118CaptureWriter::close()
+{
+    if (m_file == nullptr)
+        return;
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+bool FC37118CaptureWriter::write(uint64_t arrival_ns, const unsigned char *frame, uint32_t size)
+{
+    if (m_file == nullptr)
+        return false;
+    if (fwrite(&arrival_ns, sizeof(arrival_ns), 1, m_file) != 1 ||
+        fwrite(&size, sizeof(size), 1, m_file) != 1 ||
+        fwrite(frame, 1, size, m_file) != size)
+    {
+        Logger::getLogger()->error("Capture write failed, capture stopped");
+        close();
+        return false;
+    }
+    return true;
+}
+
+FC37118CaptureReader::FC37118CaptureReader() : m_file(nullptr)
+{
+}
+
+FC37118CaptureReader::~FC37118CaptureReader()
+{
+    close();
+}
+
+bool FC37118CaptureReader::open(const std::string &path)
+{
+    close();
+    m_file = fopen(path.c_str(), "rb");
+    if (m_file == nullptr)
+    {
+        Logger::getLogger()->error("Unable to open replay file " + path);
+        return false;
+    }
+    m_io_buffer.resize(CAPTURE_IO_BUFFER_SIZE);
+    setvbuf(m_file, m_io_buffer.data(), _IOFBF, m_io_buffer.size());
+    if (!rewind())
+    {
+        Logger::getLogger()->error(path + " is not a c37.118 capture file");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FC37118CaptureReader::close()
+{
+    if (m_file == nullptr)
+        return;
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+bool FC37118CaptureReader::rewind()
+{
+    char magic[CAPTURE_MAGIC_SIZE];
+    if (m_file == nullptr || fseek(m_file, 0, SEEK_SET) != 0)
+        return false;
+    return fread(magic, 1, CAPTURE_MAGIC_SIZE, m_file) == CAPTURE_MAGIC_SIZE &&
+           memcmp(magic, CAPTURE_MAGIC, CAPTURE_MAGIC_SIZE) == 0;
+}
+
+bool FC37118CaptureReader::next(uint64_t *arrival_ns, unsigned char *buffer, uint32_t buffer_size, uint32_t *size)
+{
+    if (m_file == nullptr)
+        return false;
+    if (fread(arrival_ns, sizeof(*arrival_ns), 1, m_file) != 1 ||
+        fread(size, sizeof(*size), 1, m_file) != 1)
+        return false;
+    if (*size > buffer_size)
+    {
+        Logger::getLogger()->error("Replay record of %u bytes exceeds the buffer size, replay stopped", *size);
+        return false;
+    }
+    return fread(buffer, 1, *size, m_file) == *size;
+}
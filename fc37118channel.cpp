@@ -0,0 +1,105 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include "fc37118channel.h"
+
+double station_fnom(PMU_Station *pmu_station)
+{
+    return (pmu_station->FNOM_get() & 1) ? 50.0 : 60.0;
+}
+
+double station_frequency(PMU_Station *pmu_station)
+{
+    if (pmu_station->FORMAT_FREQ_TYPE_get())
+        return pmu_station->FREQ_get();
+    return station_fnom(pmu_station) + pmu_station->FREQ_get() / 1000.0;
+}
+
+double station_rocof(PMU_Station *pmu_station)
+{
+    if (pmu_station->FORMAT_FREQ_TYPE_get())
+        return pmu_station->DFREQ_get();
+    return pmu_station->DFREQ_get() / 100.0;
+}
+
+bool FC37118ChannelRef::resolve(CONFIG_Frame *config_frame, unsigned int idcode, const std::string &name, bool is_angle)
+{
+    kind = ChannelKind::NONE;
+    index = -1;
+    for (station = 0; station < config_frame->pmu_station_list.size(); station++)
+    {
+        auto pmu_station = config_frame->pmu_station_list[station];
+        if (pmu_station->IDCODE_get() != idcode)
+            continue;
+
+        if (name == CHANNEL_FREQ)
+            kind = ChannelKind::FREQ;
+        else if (name == CHANNEL_DFREQ)
+            kind = ChannelKind::DFREQ;
+        for (int k = 0; kind == ChannelKind::NONE && k < pmu_station->PHNMR_get(); k++)
+        {
+            if (pmu_station->PH_NAME_get(k) == name)
+            {
+                kind = is_angle ? ChannelKind::PHASOR_ANGLE : ChannelKind::PHASOR_MAGNITUDE;
+                index = k;
+            }
+        }
+        for (int k = 0; kind == ChannelKind::NONE && k < pmu_station->ANNMR_get(); k++)
+        {
+            if (pmu_station->AN_NAME_get(k) == name)
+            {
+                kind = ChannelKind::ANALOG;
+                index = k;
+            }
+        }
+        return kind != ChannelKind::NONE;
+    }
+    return false;
+}
+
+double FC37118ChannelRef::value(CONFIG_Frame *config_frame)
+{
+    auto pmu_station = config_frame->pmu_station_list[station];
+    switch (kind)
+    {
+    case ChannelKind::FREQ:
+        return pmu_station->FREQ_get();
+    case ChannelKind::DFREQ:
+        return pmu_station->DFREQ_get();
+    case ChannelKind::PHASOR_MAGNITUDE:
+        return std::abs(pmu_station->PHASOR_VALUE_get(index));
+    case ChannelKind::PHASOR_ANGLE:
+        return std::arg(pmu_station->PHASOR_VALUE_get(index));
+    case ChannelKind::ANALOG:
+        return pmu_station->ANALOG_VALUE_get(index);
+    default:
+        return 0;
+    }
+}
+
+std::string FC37118ChannelRef::label(CONFIG_Frame *config_frame)
+{
+    auto pmu_station = config_frame->pmu_station_list[station];
+    switch (kind)
+    {
+    case ChannelKind::FREQ:
+        return CHANNEL_FREQ;
+    case ChannelKind::DFREQ:
+        return CHANNEL_DFREQ;
+    case ChannelKind::PHASOR_MAGNITUDE:
+        return pmu_station->PH_NAME_get(index) + ".Mag";
+    case ChannelKind::PHASOR_ANGLE:
+        return pmu_station->PH_NAME_get(index) + ".Ang";
+    case ChannelKind::ANALOG:
+        return pmu_station->AN_NAME_get(index);
+    default:
+        return "";
+    }
+}
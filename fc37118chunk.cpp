@@ -0,0 +1,187 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "fc37118.h"
+#include "fc37118chunk.h"
+#include "fc37118datapoint.h"
+#include "fc37118channel.h"
+#include "fc37118validation.h"
+
+FC37118Chunker::FC37118Chunker() : m_conf(nullptr),
+                                   m_config_version(0),
+                                   m_duration(1)
+{
+}
+
+FC37118Chunker::~FC37118Chunker() {}
+
+void FC37118Chunker::configure(FC37118ChunkConf *conf)
+{
+    m_conf = conf;
+    m_config_version = 0;
+    m_chunks.clear();
+}
+
+void FC37118Chunker::m_setup(CONFIG_Frame *config_frame, const std::vector<uint> &filter)
+{
+    // DATA_RATE > 0: frames per second, < 0: seconds per frame, 0 (possible with SENDER_HARD_CONFIG): taken as one frame per second
+    short rate = config_frame->DATA_RATE_get();
+    double data_rate = rate > 0 ? rate : (rate < 0 ? 1.0 / -rate : 1.0);
+    m_duration = m_conf->get_duration_ms() > 0 ? m_conf->get_duration_ms() / 1000.0 : m_conf->get_frames() / data_rate;
+    size_t frames_per_chunk = (size_t)std::ceil(std::min(m_duration, 1.0) * data_rate) + 1;
+
+    m_chunks.clear();
+    for (size_t i = 0; i < config_frame->pmu_station_list.size(); i++)
+    {
+        auto pmu_station = config_frame->pmu_station_list[i];
+        if (!filter.empty() && std::find(filter.begin(), filter.end(), pmu_station->IDCODE_get()) == filter.end())
+            continue;
+
+        StationChunk chunk;
+        chunk.station = i;
+        chunk.idcode = pmu_station->IDCODE_get();
+        chunk.asset = to_string(config_frame->IDCODE_get()) + "-" + to_string(pmu_station->IDCODE_get());
+        chunk.stn = pmu_station->STN_get();
+        for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+        {
+            chunk.labels.push_back(pmu_station->PH_NAME_get(k) + DP_MAG_SUFFIX);
+            chunk.labels.push_back(pmu_station->PH_NAME_get(k) + DP_ANG_SUFFIX);
+        }
+        for (int k = 0; k < pmu_station->ANNMR_get(); k++)
+            chunk.labels.push_back(pmu_station->AN_NAME_get(k));
+
+        chunk.is_open = false;
+        chunk.soc = 0;
+        chunk.slot = 0;
+        chunk.offsets.reserve(frames_per_chunk);
+        chunk.stats.reserve(frames_per_chunk);
+        chunk.freqs.reserve(frames_per_chunk);
+        chunk.dfreqs.reserve(frames_per_chunk);
+        chunk.channels.assign(chunk.labels.size(), std::vector<double>());
+        for (auto &channel : chunk.channels)
+            channel.reserve(frames_per_chunk);
+        chunk.bad_reasons.assign(chunk.labels.size() + 2, 0);
+        chunk.bad_offsets.assign(chunk.labels.size() + 2, std::vector<double>());
+        m_chunks.push_back(chunk);
+    }
+}
+
+/**
+ * @brief build the reading of a chunk and clear the chunk, keeping its buffers
+ */
+Reading *FC37118Chunker::m_close(StationChunk &chunk)
+{
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_IDCODE, (long)chunk.idcode));
+    dps->push_back(create_dp(DP_STN, chunk.stn));
+    dps->push_back(create_dp(DP_SOC, (long)chunk.soc));
+    dps->push_back(create_dp(DP_OFFSETS, chunk.offsets));
+    dps->push_back(create_dp(DP_STAT, chunk.stats));
+    dps->push_back(create_dp(DP_FREQ, chunk.freqs));
+    dps->push_back(create_dp(DP_DFREQ, chunk.dfreqs));
+    for (size_t c = 0; c < chunk.channels.size(); c++)
+    {
+        dps->push_back(create_dp(chunk.labels[c], chunk.channels[c]));
+        chunk.channels[c].clear();
+    }
+    auto bad_dps = new std::vector<Datapoint *>;
+    for (size_t c = 0; c < chunk.bad_reasons.size(); c++)
+    {
+        if (chunk.bad_reasons[c] == 0)
+            continue;
+        const std::string &label = c == 0 ? CHANNEL_FREQ : (c == 1 ? CHANNEL_DFREQ : chunk.labels[c - 2]);
+        auto dp_channel = create_dp(DP_BAD_CHANNEL, label);
+        auto dp_reason = create_dp(DP_BAD_REASON, FC37118Validation::to_reasons(chunk.bad_reasons[c]));
+        auto dp_offsets = create_dp(DP_OFFSETS, chunk.bad_offsets[c]);
+        bad_dps->push_back(create_dp_list(DP_BAD_DATA, new std::vector<Datapoint *>({dp_channel, dp_reason, dp_offsets}), true));
+        chunk.bad_reasons[c] = 0;
+        chunk.bad_offsets[c].clear();
+    }
+    if (bad_dps->empty())
+        delete bad_dps;
+    else
+        dps->push_back(create_dp_list(DP_BAD_DATA, bad_dps, false));
+    chunk.offsets.clear();
+    chunk.stats.clear();
+    chunk.freqs.clear();
+    chunk.dfreqs.clear();
+    chunk.is_open = false;
+    return new Reading(chunk.asset, create_dp_list(DP_CHUNK, dps, true));
+}
+
+void FC37118Chunker::append(CONFIG_Frame *config_frame, unsigned long config_version, const std::vector<uint> &filter,
+                            unsigned long soc, double fraction, FC37118Validation *validation, std::vector<FC37118Reading> &output,
+                            const std::set<unsigned short> *skipped)
+{
+    if (config_version != m_config_version)
+    {
+        flush(output);
+        m_setup(config_frame, filter);
+        m_config_version = config_version;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    long slot = (long)std::floor(fraction / m_duration + 1e-6);
+    for (auto &chunk : m_chunks)
+    {
+        if (skipped != nullptr && skipped->count(chunk.idcode) > 0)
+            continue;
+        if (chunk.is_open && (chunk.soc != soc || chunk.slot != slot))
+            output.push_back({chunk.idcode, m_close(chunk)});
+        chunk.is_open = true;
+        chunk.soc = soc;
+        chunk.slot = slot;
+
+        // validation flags laid out as FREQ, DFREQ, then the chunk channels
+        const uint8_t *bad_flags = validation != nullptr && validation->is_bad(chunk.station) ? validation->get_flags(chunk.station) : nullptr;
+        bool is_suppress = bad_flags != nullptr && validation->is_suppress();
+        if (bad_flags != nullptr)
+        {
+            for (size_t b = 0; b < chunk.bad_reasons.size(); b++)
+            {
+                if (bad_flags[b] == 0)
+                    continue;
+                chunk.bad_reasons[b] |= bad_flags[b];
+                chunk.bad_offsets[b].push_back(fraction);
+            }
+        }
+        auto is_suppressed = [is_suppress, bad_flags](size_t b)
+        { return is_suppress && bad_flags[b] != 0; };
+
+        auto pmu_station = config_frame->pmu_station_list[chunk.station];
+        chunk.offsets.push_back(fraction);
+        chunk.stats.push_back(pmu_station->STAT_get());
+        chunk.freqs.push_back(is_suppressed(0) ? nan : pmu_station->FREQ_get());
+        chunk.dfreqs.push_back(is_suppressed(1) ? nan : pmu_station->DFREQ_get());
+        size_t c = 0;
+        for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+        {
+            // as in the readings, a phasor is suppressed when its magnitude or its angle is bad
+            bool is_bad_phasor = is_suppressed(2 + c) || is_suppressed(3 + c);
+            auto phasor = pmu_station->PHASOR_VALUE_get(k);
+            chunk.channels[c++].push_back(is_bad_phasor ? nan : std::abs(phasor));
+            chunk.channels[c++].push_back(is_bad_phasor ? nan : std::arg(phasor));
+        }
+        for (int k = 0; k < pmu_station->ANNMR_get(); k++, c++)
+            chunk.channels[c].push_back(is_suppressed(2 + c) ? nan : pmu_station->ANALOG_VALUE_get(k));
+    }
+}
+
+void FC37118Chunker::flush(std::vector<FC37118Reading> &output)
+{
+    for (auto &chunk : m_chunks)
+    {
+        if (chunk.is_open)
+            output.push_back({chunk.idcode, m_close(chunk)});
+    }
+}
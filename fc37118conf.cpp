@@ -8,6 +8,9 @@
  * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
  */
 
+#include <thread>
+#include <algorithm>
+
 #include "fc37118conf.h"
 
 FC37118StnConf::FC37118StnConf() {}
@@ -51,12 +54,678 @@ void FC37118StnConf::to_PMU_station(PMU_Station *pmu_station)
     pmu_station->DIGITAL_add(m_dgnam, 0, 65535);
 }
 
+FC37118QueueConf::FC37118QueueConf() : m_is_enabled(false),
+                                       m_max_readings(1000),
+                                       m_max_memory_kb(65536),
+                                       m_policy(QueuePolicy::DROP_OLDEST),
+                                       m_keep_nth(2),
+                                       m_report_period(60)
+{
+}
+
+FC37118QueueConf::~FC37118QueueConf() {}
+
+/**
+ * @brief import the INGEST_QUEUE section. Every field is optional, an unknown POLICY makes the configuration incomplete.
+ */
+bool FC37118QueueConf::import(rapidjson::Value *value)
+{
+    std::string policy = QUEUE_POLICY_DROP_OLDEST;
+
+    retrieve(value, QUEUE_MAX_READINGS, &m_max_readings);
+    retrieve(value, QUEUE_MAX_MEMORY_KB, &m_max_memory_kb);
+    retrieve(value, QUEUE_POLICY, &policy);
+    retrieve(value, QUEUE_KEEP_NTH, &m_keep_nth);
+    retrieve(value, QUEUE_PRIORITY_IDCODES, &m_priority_idcodes);
+    retrieve(value, QUEUE_REPORT_PERIOD, &m_report_period);
+
+    if (policy == QUEUE_POLICY_DROP_OLDEST)
+        m_policy = QueuePolicy::DROP_OLDEST;
+    else if (policy == QUEUE_POLICY_DROP_NEWEST)
+        m_policy = QueuePolicy::DROP_NEWEST;
+    else if (policy == QUEUE_POLICY_KEEP_NTH)
+        m_policy = QueuePolicy::KEEP_NTH;
+    else if (policy == QUEUE_POLICY_PRIORITY)
+        m_policy = QueuePolicy::PRIORITY;
+    else
+    {
+        Logger::getLogger()->error("Unknown " INGEST_QUEUE " " QUEUE_POLICY ": " + policy);
+        return false;
+    }
+
+    if (m_max_readings == 0 || m_keep_nth == 0)
+    {
+        Logger::getLogger()->error(INGEST_QUEUE " " QUEUE_MAX_READINGS " and " QUEUE_KEEP_NTH " shall be strictly positive");
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118ParallelConf::FC37118ParallelConf() : m_nb_workers(0),
+                                             m_min_stations(16)
+{
+}
+
+FC37118ParallelConf::~FC37118ParallelConf() {}
+
+bool FC37118ParallelConf::import(rapidjson::Value *value)
+{
+    retrieve(value, PARALLEL_WORKERS, &m_nb_workers);
+    retrieve(value, PARALLEL_CPUS, &m_cpus);
+    retrieve(value, PARALLEL_MIN_STATIONS, &m_min_stations);
+
+    uint nb_cpus = std::thread::hardware_concurrency();
+    for (auto cpu : m_cpus)
+    {
+        if (nb_cpus > 0 && cpu >= nb_cpus)
+        {
+            Logger::getLogger()->error(PARALLEL_CONVERSION " " PARALLEL_CPUS ": cpu %u does not exist", cpu);
+            return false;
+        }
+    }
+    return true;
+}
+
+FC37118LowLatencyConf::FC37118LowLatencyConf() : m_sched_fifo_priority(0),
+                                                 m_rcvbuf_kb(0),
+                                                 m_tcp_nodelay(false),
+                                                 m_tcp_quickack(false),
+                                                 m_busy_poll_us(0),
+                                                 m_kernel_timestamps(false)
+{
+}
+
+FC37118LowLatencyConf::~FC37118LowLatencyConf() {}
+
+bool FC37118LowLatencyConf::import(rapidjson::Value *value)
+{
+    retrieve(value, LL_CPUS, &m_cpus);
+    retrieve(value, LL_SCHED_FIFO_PRIORITY, &m_sched_fifo_priority);
+    retrieve(value, LL_RCVBUF_KB, &m_rcvbuf_kb);
+    retrieve(value, LL_TCP_NODELAY, &m_tcp_nodelay);
+    retrieve(value, LL_TCP_QUICKACK, &m_tcp_quickack);
+    retrieve(value, LL_BUSY_POLL_US, &m_busy_poll_us);
+    retrieve(value, LL_KERNEL_TIMESTAMPS, &m_kernel_timestamps);
+
+    if (m_sched_fifo_priority > 99)
+    {
+        Logger::getLogger()->error(LOW_LATENCY " " LL_SCHED_FIFO_PRIORITY " shall be in [0, 99]");
+        return false;
+    }
+    return true;
+}
+
+FC37118DerivedConf::FC37118DerivedConf() : m_is_enabled(false),
+                                           m_rocof(true)
+{
+}
+
+FC37118DerivedConf::~FC37118DerivedConf() {}
+
+bool FC37118DerivedConf::import(rapidjson::Value *value)
+{
+    const char *role_keys[DERIVED_NB_ROLES] = {DERIVED_ROLE_VA, DERIVED_ROLE_VB, DERIVED_ROLE_VC,
+                                               DERIVED_ROLE_IA, DERIVED_ROLE_IB, DERIVED_ROLE_IC};
+    retrieve(value, DERIVED_ROCOF, &m_rocof);
+
+    if (!value->HasMember(DERIVED_ROLES) || !(*value)[DERIVED_ROLES].IsArray())
+    {
+        Logger::getLogger()->error(DERIVED " requires a " DERIVED_ROLES " array");
+        return false;
+    }
+    for (auto &roles_value : (*value)[DERIVED_ROLES].GetArray())
+    {
+        if (!roles_value.IsObject())
+            return false;
+        FC37118DerivedRoles roles;
+        roles.has_idcode = retrieve(&roles_value, STN_IDCODE, &roles.idcode);
+        for (int r = 0; r < DERIVED_NB_ROLES; r++)
+            retrieve(&roles_value, role_keys[r], &roles.names[r]);
+        m_roles.push_back(roles);
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118OscillationConf::FC37118OscillationConf() : m_is_enabled(false),
+                                                   m_window_s(60),
+                                                   m_sample_rate(10),
+                                                   m_min_freq(0.1),
+                                                   m_max_freq(2.0),
+                                                   m_emit_period_s(10)
+{
+}
+
+FC37118OscillationConf::~FC37118OscillationConf() {}
+
+bool FC37118OscillationConf::import(rapidjson::Value *value)
+{
+    retrieve(value, OSC_WINDOW_S, &m_window_s);
+    retrieve(value, OSC_SAMPLE_RATE, &m_sample_rate);
+    retrieve(value, OSC_MIN_FREQ, &m_min_freq);
+    retrieve(value, OSC_MAX_FREQ, &m_max_freq);
+    retrieve(value, OSC_EMIT_PERIOD_S, &m_emit_period_s);
+
+    if (m_window_s == 0 || m_sample_rate == 0 || m_emit_period_s == 0 ||
+        m_min_freq <= 0 || m_max_freq <= m_min_freq || 2 * m_max_freq >= m_sample_rate)
+    {
+        Logger::getLogger()->error(OSCILLATION ": inconsistent window, sample rate or frequency band");
+        return false;
+    }
+
+    if (!value->HasMember(OSC_CHANNELS) || !(*value)[OSC_CHANNELS].IsArray())
+    {
+        Logger::getLogger()->error(OSCILLATION " requires a " OSC_CHANNELS " array");
+        return false;
+    }
+    for (auto &channel_value : (*value)[OSC_CHANNELS].GetArray())
+    {
+        FC37118OscillationChannelConf channel;
+        channel.quantity = OSC_QUANTITY_MAG;
+        if (!channel_value.IsObject() ||
+            !retrieve(&channel_value, STN_IDCODE, &channel.idcode) ||
+            !retrieve(&channel_value, OSC_CHANNEL, &channel.channel))
+        {
+            Logger::getLogger()->error(OSCILLATION ": each channel requires " STN_IDCODE " and " OSC_CHANNEL);
+            return false;
+        }
+        retrieve(&channel_value, OSC_QUANTITY, &channel.quantity);
+        m_channels.push_back(channel);
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118TriggerConf::FC37118TriggerConf() : m_is_enabled(false),
+                                           m_output_rate(1),
+                                           m_pre_frames(50),
+                                           m_post_frames(150),
+                                           m_freq_deviation(0),
+                                           m_rocof(0),
+                                           m_voltage_sag(0),
+                                           m_angle_jump(0),
+                                           m_stat_mask(0xC000)
+{
+}
+
+FC37118TriggerConf::~FC37118TriggerConf() {}
+
+bool FC37118TriggerConf::import(rapidjson::Value *value)
+{
+    retrieve(value, TRG_OUTPUT_RATE, &m_output_rate);
+    retrieve(value, TRG_PRE_FRAMES, &m_pre_frames);
+    retrieve(value, TRG_POST_FRAMES, &m_post_frames);
+    retrieve(value, TRG_FREQ_DEVIATION, &m_freq_deviation);
+    retrieve(value, TRG_ROCOF, &m_rocof);
+    retrieve(value, TRG_VOLTAGE_SAG, &m_voltage_sag);
+    retrieve(value, TRG_ANGLE_JUMP, &m_angle_jump);
+    retrieve(value, TRG_VOLTAGE_CHANNELS, &m_voltage_channels);
+    retrieve(value, TRG_STAT_MASK, &m_stat_mask);
+
+    if (m_output_rate <= 0 || m_voltage_sag >= 1)
+    {
+        Logger::getLogger()->error(TRIGGER ": " TRG_OUTPUT_RATE " shall be positive and " TRG_VOLTAGE_SAG " lower than 1");
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118ChunkConf::FC37118ChunkConf() : m_is_enabled(false),
+                                       m_frames(50),
+                                       m_duration_ms(0)
+{
+}
+
+FC37118ChunkConf::~FC37118ChunkConf() {}
+
+bool FC37118ChunkConf::import(rapidjson::Value *value)
+{
+    retrieve(value, CHUNK_FRAMES, &m_frames);
+    retrieve(value, CHUNK_DURATION_MS, &m_duration_ms);
+    if (m_frames == 0 && m_duration_ms == 0)
+    {
+        Logger::getLogger()->error(CHUNK " requires " CHUNK_FRAMES " or " CHUNK_DURATION_MS);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118TlsConf::FC37118TlsConf() : m_is_enabled(false),
+                                   m_ktls(true)
+{
+}
+
+FC37118TlsConf::~FC37118TlsConf() {}
+
+bool FC37118TlsConf::import(rapidjson::Value *value)
+{
+    retrieve(value, TLS_CA_FILE, &m_ca_file);
+    retrieve(value, TLS_CERT_FILE, &m_cert_file);
+    retrieve(value, TLS_KEY_FILE, &m_key_file);
+    retrieve(value, TLS_SERVER_NAME, &m_server_name);
+    retrieve(value, TLS_PINNED_SHA256, &m_pinned_sha256);
+    retrieve(value, TLS_KTLS, &m_ktls);
+    if (m_ca_file.empty() && m_pinned_sha256.empty())
+    {
+        Logger::getLogger()->error(TLS " requires " TLS_CA_FILE " or " TLS_PINNED_SHA256 " to authenticate the PMU");
+        return false;
+    }
+    if (m_cert_file.empty() != m_key_file.empty())
+    {
+        Logger::getLogger()->error(TLS " " TLS_CERT_FILE " and " TLS_KEY_FILE " shall be set together");
+        return false;
+    }
+    for (auto &fingerprint : m_pinned_sha256)
+    {
+        fingerprint.erase(std::remove(fingerprint.begin(), fingerprint.end(), ':'), fingerprint.end());
+        std::transform(fingerprint.begin(), fingerprint.end(), fingerprint.begin(), ::tolower);
+        if (fingerprint.size() != 64)
+        {
+            Logger::getLogger()->error(TLS " " TLS_PINNED_SHA256 " shall be SHA-256 fingerprints in hexadecimal");
+            return false;
+        }
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118RedundancyConf::FC37118RedundancyConf() : m_is_enabled(false),
+                                                 m_window_frames(256),
+                                                 m_report_period(60)
+{
+}
+
+FC37118RedundancyConf::~FC37118RedundancyConf() {}
+
+bool FC37118RedundancyConf::import(rapidjson::Value *value)
+{
+    retrieve(value, RED_WINDOW_FRAMES, &m_window_frames);
+    retrieve(value, RED_REPORT_PERIOD, &m_report_period);
+
+    if (!value->HasMember(RED_PATHS) || !(*value)[RED_PATHS].IsArray())
+    {
+        Logger::getLogger()->error(REDUNDANCY " requires a " RED_PATHS " array");
+        return false;
+    }
+    for (auto &path_value : (*value)[RED_PATHS].GetArray())
+    {
+        FC37118PathConf path;
+        if (!path_value.IsObject() ||
+            !retrieve(&path_value, IP_ADDR, &path.ip_addr) ||
+            !retrieve(&path_value, IP_PORT, &path.port))
+        {
+            Logger::getLogger()->error(REDUNDANCY " " RED_PATHS " entries require " IP_ADDR " and " IP_PORT);
+            return false;
+        }
+        m_paths.push_back(path);
+    }
+    if (m_paths.empty() || m_paths.size() >= RED_MAX_PATHS || m_window_frames == 0)
+    {
+        Logger::getLogger()->error(REDUNDANCY " requires 1 to %d " RED_PATHS " and a positive " RED_WINDOW_FRAMES, RED_MAX_PATHS - 1);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118ShmConf::FC37118ShmConf() : m_is_enabled(false),
+                                   m_name("/fc37118"),
+                                   m_slots(1024),
+                                   m_max_channels(1024)
+{
+}
+
+FC37118ShmConf::~FC37118ShmConf() {}
+
+bool FC37118ShmConf::import(rapidjson::Value *value)
+{
+    retrieve(value, SHM_NAME, &m_name);
+    retrieve(value, SHM_SLOTS, &m_slots);
+    retrieve(value, SHM_MAX_CHANNELS, &m_max_channels);
+    if (m_name.size() < 2 || m_name[0] != '/' || m_name.find('/', 1) != std::string::npos)
+    {
+        Logger::getLogger()->error(SHM " " SHM_NAME " shall be a name starting with '/', e.g. /fc37118");
+        return false;
+    }
+    if (m_slots < 2 || m_max_channels == 0)
+    {
+        Logger::getLogger()->error(SHM " requires at least 2 " SHM_SLOTS " and a positive " SHM_MAX_CHANNELS);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118UringConf::FC37118UringConf() : m_is_enabled(false),
+                                       m_buffers(64),
+                                       m_buffer_size(16384)
+{
+}
+
+FC37118UringConf::~FC37118UringConf() {}
+
+bool FC37118UringConf::import(rapidjson::Value *value)
+{
+    retrieve(value, URING_BUFFERS, &m_buffers);
+    retrieve(value, URING_BUFFER_SIZE, &m_buffer_size);
+    if (m_buffers == 0 || m_buffers > URING_MAX_BUFFERS || (m_buffers & (m_buffers - 1)) != 0)
+    {
+        Logger::getLogger()->error(IO_URING " " URING_BUFFERS " shall be a power of 2, up to %d", URING_MAX_BUFFERS);
+        return false;
+    }
+    if (m_buffer_size == 0 || m_buffer_size > URING_MAX_BUFFER_SIZE)
+    {
+        Logger::getLogger()->error(IO_URING " " URING_BUFFER_SIZE " shall be in [1, %d]", URING_MAX_BUFFER_SIZE);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118SoakConf::FC37118SoakConf() : m_is_enabled(false),
+                                     m_sample_period_s(60),
+                                     m_warmup_s(600),
+                                     m_max_growth_kb(10240)
+{
+}
+
+FC37118SoakConf::~FC37118SoakConf() {}
+
+bool FC37118SoakConf::import(rapidjson::Value *value)
+{
+    retrieve(value, SOAK_SAMPLE_PERIOD_S, &m_sample_period_s);
+    retrieve(value, SOAK_WARMUP_S, &m_warmup_s);
+    retrieve(value, SOAK_MAX_GROWTH_KB, &m_max_growth_kb);
+    if (m_sample_period_s == 0)
+    {
+        Logger::getLogger()->error(SOAK " " SOAK_SAMPLE_PERIOD_S " shall be positive");
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118AngleDifferenceConf::FC37118AngleDifferenceConf() : m_is_enabled(false),
+                                                           m_hysteresis_deg(1),
+                                                           m_decimation(1)
+{
+}
+
+FC37118AngleDifferenceConf::~FC37118AngleDifferenceConf() {}
+
+bool FC37118AngleDifferenceConf::m_import_phasor(rapidjson::Value *value, FC37118PhasorConf *phasor)
+{
+    return value->IsObject() &&
+           retrieve(value, STN_IDCODE, &phasor->idcode) &&
+           retrieve(value, ADIFF_CHANNEL, &phasor->channel);
+}
+
+bool FC37118AngleDifferenceConf::import(rapidjson::Value *value)
+{
+    retrieve(value, ADIFF_HYSTERESIS_DEG, &m_hysteresis_deg);
+    retrieve(value, ADIFF_DECIMATION, &m_decimation);
+    if (m_hysteresis_deg < 0 || m_decimation == 0)
+    {
+        Logger::getLogger()->error(ANGLE_DIFFERENCE ": " ADIFF_HYSTERESIS_DEG " shall not be negative and " ADIFF_DECIMATION " shall be positive");
+        return false;
+    }
+
+    // default reference of the pairs
+    FC37118PhasorConf reference;
+    rapidjson::Value *reference_value;
+    bool has_reference = retrieve(value, ADIFF_REFERENCE, reference_value);
+    if (has_reference && !m_import_phasor(reference_value, &reference))
+    {
+        Logger::getLogger()->error(ANGLE_DIFFERENCE ": " ADIFF_REFERENCE " requires " STN_IDCODE " and " ADIFF_CHANNEL);
+        return false;
+    }
+
+    if (!value->HasMember(ADIFF_PAIRS) || !(*value)[ADIFF_PAIRS].IsArray())
+    {
+        Logger::getLogger()->error(ANGLE_DIFFERENCE " requires a " ADIFF_PAIRS " array");
+        return false;
+    }
+    for (auto &pair_value : (*value)[ADIFF_PAIRS].GetArray())
+    {
+        FC37118AngleDifferencePairConf pair;
+        pair.reference = reference;
+        pair.alarm_deg = 0;
+        if (!m_import_phasor(&pair_value, &pair.phasor))
+        {
+            Logger::getLogger()->error(ANGLE_DIFFERENCE ": each pair requires " STN_IDCODE " and " ADIFF_CHANNEL);
+            return false;
+        }
+        rapidjson::Value *pair_reference;
+        if (retrieve(&pair_value, ADIFF_REFERENCE, pair_reference))
+        {
+            if (!m_import_phasor(pair_reference, &pair.reference))
+            {
+                Logger::getLogger()->error(ANGLE_DIFFERENCE ": " ADIFF_REFERENCE " requires " STN_IDCODE " and " ADIFF_CHANNEL);
+                return false;
+            }
+        }
+        else if (!has_reference)
+        {
+            Logger::getLogger()->error(ANGLE_DIFFERENCE ": no " ADIFF_REFERENCE " for " + pair.phasor.channel);
+            return false;
+        }
+        pair.name = std::to_string(pair.phasor.idcode) + "." + pair.phasor.channel;
+        retrieve(&pair_value, ADIFF_NAME, &pair.name);
+        retrieve(&pair_value, ADIFF_ALARM_DEG, &pair.alarm_deg);
+        if (pair.alarm_deg < 0 || pair.alarm_deg > 180)
+        {
+            Logger::getLogger()->error(ANGLE_DIFFERENCE ": " ADIFF_ALARM_DEG " of " + pair.name + " shall be in [0, 180]");
+            return false;
+        }
+        m_pairs.push_back(pair);
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118ServerConf::FC37118ServerConf() : m_is_enabled(false),
+                                         m_ip_addr("0.0.0.0"),
+                                         m_port(4712),
+                                         m_max_clients(8),
+                                         m_queue_frames(256)
+{
+}
+
+FC37118ServerConf::~FC37118ServerConf() {}
+
+bool FC37118ServerConf::import(rapidjson::Value *value)
+{
+    retrieve(value, IP_ADDR, &m_ip_addr);
+    retrieve(value, IP_PORT, &m_port);
+    retrieve(value, SRV_MAX_CLIENTS, &m_max_clients);
+    retrieve(value, SRV_QUEUE_FRAMES, &m_queue_frames);
+    if (m_port == 0 || m_port > 65535 || m_max_clients == 0 || m_queue_frames == 0)
+    {
+        Logger::getLogger()->error(SERVER " requires a valid " IP_PORT ", and positive " SRV_MAX_CLIENTS " and " SRV_QUEUE_FRAMES);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118ArchiveConf::FC37118ArchiveConf() : m_is_enabled(false),
+                                           m_segment_mb(256),
+                                           m_segment_s(3600),
+                                           m_max_size_mb(10240),
+                                           m_block_kb(64),
+                                           m_index_period_s(1),
+                                           m_compression(ARC_COMPRESSION_NONE)
+{
+}
+
+FC37118ArchiveConf::~FC37118ArchiveConf() {}
+
+bool FC37118ArchiveConf::import(rapidjson::Value *value)
+{
+    if (!retrieve(value, ARC_DIRECTORY, &m_directory) || m_directory.empty())
+    {
+        Logger::getLogger()->error(ARCHIVE " requires a " ARC_DIRECTORY);
+        return false;
+    }
+    retrieve(value, ARC_SEGMENT_MB, &m_segment_mb);
+    retrieve(value, ARC_SEGMENT_S, &m_segment_s);
+    retrieve(value, ARC_MAX_SIZE_MB, &m_max_size_mb);
+    retrieve(value, ARC_BLOCK_KB, &m_block_kb);
+    retrieve(value, ARC_INDEX_PERIOD_S, &m_index_period_s);
+    retrieve(value, ARC_COMPRESSION, &m_compression);
+    if (m_segment_mb == 0 || m_segment_s == 0 || m_block_kb == 0 || m_block_kb > 65536 || m_index_period_s == 0)
+    {
+        Logger::getLogger()->error(ARCHIVE ": " ARC_SEGMENT_MB ", " ARC_SEGMENT_S ", " ARC_BLOCK_KB " (up to 65536) and " ARC_INDEX_PERIOD_S " shall be positive");
+        return false;
+    }
+    if (m_max_size_mb != 0 && m_max_size_mb < 2 * m_segment_mb)
+    {
+        Logger::getLogger()->error(ARCHIVE ": " ARC_MAX_SIZE_MB " shall be 0 or at least twice " ARC_SEGMENT_MB);
+        return false;
+    }
+    if (m_compression != ARC_COMPRESSION_NONE && m_compression != ARC_COMPRESSION_ZLIB)
+    {
+        Logger::getLogger()->error("Unknown " ARCHIVE " " ARC_COMPRESSION ": " + m_compression);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118FastLaneConf::FC37118FastLaneConf() : m_is_enabled(false),
+                                             m_stat_mask(0xC800),
+                                             m_freq_deviation(0),
+                                             m_rocof(0),
+                                             m_report_period(60)
+{
+}
+
+FC37118FastLaneConf::~FC37118FastLaneConf() {}
+
+bool FC37118FastLaneConf::import(rapidjson::Value *value)
+{
+    retrieve(value, FAST_STAT_MASK, &m_stat_mask);
+    retrieve(value, FAST_FREQ_DEVIATION, &m_freq_deviation);
+    retrieve(value, FAST_ROCOF, &m_rocof);
+    retrieve(value, FAST_REPORT_PERIOD, &m_report_period);
+    if (m_stat_mask > 0xFFFF || m_freq_deviation < 0 || m_rocof < 0)
+    {
+        Logger::getLogger()->error(FAST_LANE ": " FAST_STAT_MASK " shall fit in 16 bits, " FAST_FREQ_DEVIATION " and " FAST_ROCOF " shall not be negative");
+        return false;
+    }
+    if (m_stat_mask == 0 && m_freq_deviation == 0 && m_rocof == 0)
+    {
+        Logger::getLogger()->error(FAST_LANE ": no criterion, set " FAST_STAT_MASK ", " FAST_FREQ_DEVIATION " or " FAST_ROCOF);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118LoadSheddingConf::FC37118LoadSheddingConf() : m_is_enabled(false),
+                                                     m_budget_percent(80),
+                                                     m_overload_s(2),
+                                                     m_recovery_percent(50),
+                                                     m_recovery_s(10)
+{
+}
+
+FC37118LoadSheddingConf::~FC37118LoadSheddingConf() {}
+
+bool FC37118LoadSheddingConf::import(rapidjson::Value *value)
+{
+    retrieve(value, SHED_BUDGET_PERCENT, &m_budget_percent);
+    retrieve(value, SHED_OVERLOAD_S, &m_overload_s);
+    retrieve(value, SHED_RECOVERY_PERCENT, &m_recovery_percent);
+    retrieve(value, SHED_RECOVERY_S, &m_recovery_s);
+    if (m_budget_percent <= 0 || m_overload_s == 0 || m_recovery_percent <= 0 || m_recovery_percent >= 100 || m_recovery_s == 0)
+    {
+        Logger::getLogger()->error(LOAD_SHEDDING ": " SHED_BUDGET_PERCENT ", " SHED_OVERLOAD_S " and " SHED_RECOVERY_S " shall be positive, " SHED_RECOVERY_PERCENT " between 0 and 100");
+        return false;
+    }
+
+    if (!value->HasMember(SHED_LEVELS) || !(*value)[SHED_LEVELS].IsArray() || (*value)[SHED_LEVELS].Size() == 0)
+    {
+        Logger::getLogger()->error(LOAD_SHEDDING " requires a " SHED_LEVELS " array");
+        return false;
+    }
+    m_levels.clear();
+    for (auto &level_value : (*value)[SHED_LEVELS].GetArray())
+    {
+        FC37118LoadLevelConf level;
+        retrieve(&level_value, SHED_DECIMATION, &level.decimation);
+        retrieve(&level_value, SHED_MAX_PHASORS, &level.max_phasors);
+        retrieve(&level_value, SHED_MAX_ANALOGS, &level.max_analogs);
+        retrieve(&level_value, SHED_COMPACT, &level.is_compact);
+        if (level.decimation == 0 || level.max_phasors < -1 || level.max_analogs < -1)
+        {
+            Logger::getLogger()->error(LOAD_SHEDDING ": " SHED_DECIMATION " shall be positive, " SHED_MAX_PHASORS " and " SHED_MAX_ANALOGS " -1 or more");
+            return false;
+        }
+        m_levels.push_back(level);
+    }
+    m_is_enabled = true;
+    return true;
+}
+
+FC37118ValidationConf::FC37118ValidationConf() : m_is_enabled(false),
+                                                 m_mode(VAL_MODE_ANNOTATE),
+                                                 m_voltage_min(0),
+                                                 m_voltage_max(0),
+                                                 m_current_max(0),
+                                                 m_freq_deviation(5),
+                                                 m_frozen_frames(50),
+                                                 m_max_mag_step_percent(0),
+                                                 m_max_angle_step_deg(0),
+                                                 m_max_freq_slope(0),
+                                                 m_stat_mask(0xC000),
+                                                 m_report_period(60)
+{
+}
+
+FC37118ValidationConf::~FC37118ValidationConf() {}
+
+bool FC37118ValidationConf::import(rapidjson::Value *value)
+{
+    retrieve(value, VAL_MODE, &m_mode);
+    retrieve(value, VAL_VOLTAGE_MIN, &m_voltage_min);
+    retrieve(value, VAL_VOLTAGE_MAX, &m_voltage_max);
+    retrieve(value, VAL_CURRENT_MAX, &m_current_max);
+    retrieve(value, VAL_FREQ_DEVIATION, &m_freq_deviation);
+    retrieve(value, VAL_FROZEN_FRAMES, &m_frozen_frames);
+    retrieve(value, VAL_MAX_MAG_STEP_PERCENT, &m_max_mag_step_percent);
+    retrieve(value, VAL_MAX_ANGLE_STEP_DEG, &m_max_angle_step_deg);
+    retrieve(value, VAL_MAX_FREQ_SLOPE, &m_max_freq_slope);
+    retrieve(value, VAL_STAT_MASK, &m_stat_mask);
+    retrieve(value, VAL_REPORT_PERIOD, &m_report_period);
+    if (m_mode != VAL_MODE_ANNOTATE && m_mode != VAL_MODE_SUPPRESS)
+    {
+        Logger::getLogger()->error("Unknown " VALIDATION " " VAL_MODE ": " + m_mode);
+        return false;
+    }
+    if (m_voltage_min < 0 || m_voltage_max < 0 || m_current_max < 0 || m_freq_deviation < 0 ||
+        m_max_mag_step_percent < 0 || m_max_angle_step_deg < 0 || m_max_freq_slope < 0 || m_stat_mask > 0xFFFF ||
+        (m_voltage_max > 0 && m_voltage_min >= m_voltage_max))
+    {
+        Logger::getLogger()->error(VALIDATION ": the bounds and steps shall not be negative, " VAL_VOLTAGE_MIN " lower than " VAL_VOLTAGE_MAX);
+        return false;
+    }
+    m_is_enabled = true;
+    return true;
+}
+
 FC37118Conf::FC37118Conf() : m_is_complete(false),
-                             m_request_config_to_pmu(false)
+                             m_is_dictionary_labels(false),
+                             m_request_config_to_pmu(false),
+                             m_replay_realtime(true),
+                             m_replay_loops(1)
 {
 }
 
-FC37118Conf::FC37118Conf(const std::string &json_config)
+FC37118Conf::FC37118Conf(const std::string &json_config) : FC37118Conf()
 {
     import_json(json_config);
 }
@@ -84,8 +753,83 @@ void FC37118Conf::import_json(const std::string &json_config)
     is_complete &= retrieve(&doc, STREAMSOURCE_IDCODE, &m_pmu_IDCODE);
     is_complete &= retrieve(&doc, STN_IDCODES_FILTER, &m_stn_idcodes_filter);
     is_complete &= retrieve(&doc, SPLIT_STATIONS, &m_is_split_stations);
+    retrieve(&doc, DICTIONARY_LABELS, &m_is_dictionary_labels);
     is_complete &= retrieve(&doc, REQUEST_CONFIG_TO_SENDER, &m_request_config_to_pmu);
 
+    m_import_capture_replay(&doc);
+
+    rapidjson::Value *queue_conf;
+    if (retrieve(&doc, INGEST_QUEUE, queue_conf) && queue_conf->IsObject())
+        is_complete &= m_queue_conf.import(queue_conf);
+
+    rapidjson::Value *parallel_conf;
+    if (retrieve(&doc, PARALLEL_CONVERSION, parallel_conf) && parallel_conf->IsObject())
+        is_complete &= m_parallel_conf.import(parallel_conf);
+
+    rapidjson::Value *low_latency_conf;
+    if (retrieve(&doc, LOW_LATENCY, low_latency_conf) && low_latency_conf->IsObject())
+        is_complete &= m_low_latency_conf.import(low_latency_conf);
+
+    rapidjson::Value *derived_conf;
+    if (retrieve(&doc, DERIVED, derived_conf) && derived_conf->IsObject())
+        is_complete &= m_derived_conf.import(derived_conf);
+
+    rapidjson::Value *oscillation_conf;
+    if (retrieve(&doc, OSCILLATION, oscillation_conf) && oscillation_conf->IsObject())
+        is_complete &= m_oscillation_conf.import(oscillation_conf);
+
+    rapidjson::Value *trigger_conf;
+    if (retrieve(&doc, TRIGGER, trigger_conf) && trigger_conf->IsObject())
+        is_complete &= m_trigger_conf.import(trigger_conf);
+
+    rapidjson::Value *chunk_conf;
+    if (retrieve(&doc, CHUNK, chunk_conf) && chunk_conf->IsObject())
+        is_complete &= m_chunk_conf.import(chunk_conf);
+
+    rapidjson::Value *tls_conf;
+    if (retrieve(&doc, TLS, tls_conf) && tls_conf->IsObject())
+        is_complete &= m_tls_conf.import(tls_conf);
+
+    rapidjson::Value *redundancy_conf;
+    if (retrieve(&doc, REDUNDANCY, redundancy_conf) && redundancy_conf->IsObject())
+        is_complete &= m_redundancy_conf.import(redundancy_conf);
+
+    rapidjson::Value *shm_conf;
+    if (retrieve(&doc, SHM, shm_conf) && shm_conf->IsObject())
+        is_complete &= m_shm_conf.import(shm_conf);
+
+    rapidjson::Value *soak_conf;
+    if (retrieve(&doc, SOAK, soak_conf) && soak_conf->IsObject())
+        is_complete &= m_soak_conf.import(soak_conf);
+
+    rapidjson::Value *uring_conf;
+    if (retrieve(&doc, IO_URING, uring_conf) && uring_conf->IsObject())
+        is_complete &= m_uring_conf.import(uring_conf);
+
+    rapidjson::Value *angle_difference_conf;
+    if (retrieve(&doc, ANGLE_DIFFERENCE, angle_difference_conf) && angle_difference_conf->IsObject())
+        is_complete &= m_angle_difference_conf.import(angle_difference_conf);
+
+    rapidjson::Value *server_conf;
+    if (retrieve(&doc, SERVER, server_conf) && server_conf->IsObject())
+        is_complete &= m_server_conf.import(server_conf);
+
+    rapidjson::Value *archive_conf;
+    if (retrieve(&doc, ARCHIVE, archive_conf) && archive_conf->IsObject())
+        is_complete &= m_archive_conf.import(archive_conf);
+
+    rapidjson::Value *fast_lane_conf;
+    if (retrieve(&doc, FAST_LANE, fast_lane_conf) && fast_lane_conf->IsObject())
+        is_complete &= m_fast_lane_conf.import(fast_lane_conf);
+
+    rapidjson::Value *load_shedding_conf;
+    if (retrieve(&doc, LOAD_SHEDDING, load_shedding_conf) && load_shedding_conf->IsObject())
+        is_complete &= m_load_shedding_conf.import(load_shedding_conf);
+
+    rapidjson::Value *validation_conf;
+    if (retrieve(&doc, VALIDATION, validation_conf) && validation_conf->IsObject())
+        is_complete &= m_validation_conf.import(validation_conf);
+
     if (!m_request_config_to_pmu)
     {
         rapidjson::Value *pmu_hard_conf;
@@ -116,6 +860,23 @@ void FC37118Conf::import_json(const std::string &json_config)
     m_is_complete = is_complete;
 }
 
+/**
+ * @brief import the optional CAPTURE and REPLAY sections, both are disabled when missing
+ */
+void FC37118Conf::m_import_capture_replay(rapidjson::Value *doc)
+{
+    rapidjson::Value *section;
+    if (retrieve(doc, CAPTURE, section) && section->IsObject())
+        retrieve(section, CAPTURE_FILE, &m_capture_file);
+
+    if (retrieve(doc, REPLAY, section) && section->IsObject())
+    {
+        retrieve(section, REPLAY_FILE, &m_replay_file);
+        retrieve(section, REPLAY_REALTIME, &m_replay_realtime);
+        retrieve(section, REPLAY_LOOPS, &m_replay_loops);
+    }
+}
+
 void FC37118Conf::to_conf_frame(CONFIG_Frame *conf_frame)
 {
     conf_frame->IDCODE_set(m_pmu_IDCODE);
@@ -0,0 +1,286 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cmath>
+
+#include "fc37118.h"
+#include "fc37118derived.h"
+#include "fc37118datapoint.h"
+#include "fc37118channel.h"
+
+#define SQRT3_2 0.8660254f
+#define ROLE_VA 0
+#define ROLE_IA 3
+#define SEQ_V0 0
+#define SEQ_I0 3
+#define POWER_TOTAL 3
+
+FC37118Derived::FC37118Derived() : m_conf(nullptr),
+                                   m_config_version(0),
+                                   m_nb_stations(0),
+                                   m_prev_time(0)
+{
+}
+
+FC37118Derived::~FC37118Derived() {}
+
+void FC37118Derived::configure(FC37118DerivedConf *conf)
+{
+    m_conf = conf;
+    m_config_version = 0;
+    m_nb_stations = 0;
+}
+
+/**
+ * @brief find the phasor index of each role, from the roles of the station or from the default roles
+ */
+void FC37118Derived::m_resolve_roles(CONFIG_Frame *config_frame)
+{
+    auto all_roles = m_conf->get_roles();
+    m_nb_stations = config_frame->pmu_station_list.size();
+
+    for (int r = 0; r < DERIVED_NB_ROLES; r++)
+    {
+        m_channels[r].assign(m_nb_stations, -1);
+        m_re[r].assign(m_nb_stations, 0);
+        m_im[r].assign(m_nb_stations, 0);
+    }
+    for (int s = 0; s < DERIVED_NB_SEQUENCES; s++)
+    {
+        m_seq_re[s].assign(m_nb_stations, 0);
+        m_seq_im[s].assign(m_nb_stations, 0);
+    }
+    for (int p = 0; p < DERIVED_NB_POWERS; p++)
+    {
+        m_p[p].assign(m_nb_stations, 0);
+        m_q[p].assign(m_nb_stations, 0);
+    }
+    m_has_voltages.assign(m_nb_stations, 0);
+    m_has_currents.assign(m_nb_stations, 0);
+    m_has_roles.assign(m_nb_stations, 0);
+    m_fnom.assign(m_nb_stations, 0);
+    m_prev_angle.assign(m_nb_stations, 0);
+    m_freq.assign(m_nb_stations, 0);
+    m_rocof.assign(m_nb_stations, 0);
+    m_history.assign(m_nb_stations, 0);
+
+    for (size_t i = 0; i < m_nb_stations; i++)
+    {
+        auto pmu_station = config_frame->pmu_station_list[i];
+        m_fnom[i] = station_fnom(pmu_station);
+
+        const FC37118DerivedRoles *roles = nullptr;
+        for (auto &candidate : all_roles)
+        {
+            if (candidate.has_idcode && candidate.idcode == pmu_station->IDCODE_get())
+                roles = &candidate;
+            else if (!candidate.has_idcode && roles == nullptr)
+                roles = &candidate;
+        }
+        if (roles == nullptr)
+            continue;
+        for (int r = 0; r < DERIVED_NB_ROLES; r++)
+        {
+            if (roles->names[r].empty())
+                continue;
+            for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+            {
+                if (pmu_station->PH_NAME_get(k) == roles->names[r])
+                {
+                    m_channels[r][i] = k;
+                    m_has_roles[i] = 1;
+                    break;
+                }
+            }
+        }
+        m_has_voltages[i] = m_channels[0][i] >= 0 && m_channels[1][i] >= 0 && m_channels[2][i] >= 0;
+        m_has_currents[i] = m_channels[3][i] >= 0 && m_channels[4][i] >= 0 && m_channels[5][i] >= 0;
+    }
+    m_prev_time = 0;
+}
+
+void FC37118Derived::m_gather(CONFIG_Frame *config_frame)
+{
+    for (size_t i = 0; i < m_nb_stations; i++)
+    {
+        if (!m_has_roles[i])
+            continue;
+        auto pmu_station = config_frame->pmu_station_list[i];
+        for (int r = 0; r < DERIVED_NB_ROLES; r++)
+        {
+            if (m_channels[r][i] < 0)
+                continue;
+            auto phasor = pmu_station->PHASOR_VALUE_get(m_channels[r][i]);
+            m_re[r][i] = phasor.real();
+            m_im[r][i] = phasor.imag();
+        }
+    }
+}
+
+/**
+ * @brief zero, positive and negative sequences of the three phases starting at first_role, with a = exp(j2pi/3):
+ * X0 = (A + B + C) / 3, X1 = (A + aB + a²C) / 3, X2 = (A + a²B + aC) / 3
+ */
+void FC37118Derived::m_compute_sequences(int first_role, int first_sequence)
+{
+    const float *ar = m_re[first_role].data(), *ai = m_im[first_role].data();
+    const float *br = m_re[first_role + 1].data(), *bi = m_im[first_role + 1].data();
+    const float *cr = m_re[first_role + 2].data(), *ci = m_im[first_role + 2].data();
+    float *x0r = m_seq_re[first_sequence].data(), *x0i = m_seq_im[first_sequence].data();
+    float *x1r = m_seq_re[first_sequence + 1].data(), *x1i = m_seq_im[first_sequence + 1].data();
+    float *x2r = m_seq_re[first_sequence + 2].data(), *x2i = m_seq_im[first_sequence + 2].data();
+    const float third = 1.0f / 3.0f;
+
+    for (size_t i = 0; i < m_nb_stations; i++)
+    {
+        float bc_sum_r = br[i] + cr[i], bc_sum_i = bi[i] + ci[i];
+        float bc_diff_r = br[i] - cr[i], bc_diff_i = bi[i] - ci[i];
+        x0r[i] = (ar[i] + bc_sum_r) * third;
+        x0i[i] = (ai[i] + bc_sum_i) * third;
+        x1r[i] = (ar[i] - 0.5f * bc_sum_r - SQRT3_2 * bc_diff_i) * third;
+        x1i[i] = (ai[i] - 0.5f * bc_sum_i + SQRT3_2 * bc_diff_r) * third;
+        x2r[i] = (ar[i] - 0.5f * bc_sum_r + SQRT3_2 * bc_diff_i) * third;
+        x2i[i] = (ai[i] - 0.5f * bc_sum_i - SQRT3_2 * bc_diff_r) * third;
+    }
+}
+
+/**
+ * @brief per phase complex power S = V.conj(I), phasors being rms values
+ */
+void FC37118Derived::m_compute_powers()
+{
+    float *pt = m_p[POWER_TOTAL].data(), *qt = m_q[POWER_TOTAL].data();
+    for (size_t i = 0; i < m_nb_stations; i++)
+    {
+        pt[i] = 0;
+        qt[i] = 0;
+    }
+    for (int phase = 0; phase < 3; phase++)
+    {
+        const float *vr = m_re[ROLE_VA + phase].data(), *vi = m_im[ROLE_VA + phase].data();
+        const float *ir = m_re[ROLE_IA + phase].data(), *ii = m_im[ROLE_IA + phase].data();
+        float *p = m_p[phase].data(), *q = m_q[phase].data();
+        for (size_t i = 0; i < m_nb_stations; i++)
+        {
+            p[i] = vr[i] * ir[i] + vi[i] * ii[i];
+            q[i] = vi[i] * ir[i] - vr[i] * ii[i];
+            pt[i] += p[i];
+            qt[i] += q[i];
+        }
+    }
+}
+
+/**
+ * @brief frequency from the rotation of the unwrapped reference angle (positive sequence voltage, VA otherwise)
+ * f = fnom + dangle / (2pi.dt), and ROCOF = df / dt
+ */
+void FC37118Derived::m_compute_frequencies(double frame_time)
+{
+    double dt = frame_time - m_prev_time;
+    m_prev_time = frame_time;
+
+    for (size_t i = 0; i < m_nb_stations; i++)
+    {
+        double angle;
+        if (m_has_voltages[i])
+            angle = atan2(m_seq_im[SEQ_V0 + 1][i], m_seq_re[SEQ_V0 + 1][i]);
+        else if (m_channels[ROLE_VA][i] >= 0)
+            angle = atan2(m_im[ROLE_VA][i], m_re[ROLE_VA][i]);
+        else
+            continue;
+
+        if (m_history[i] > 0 && dt > 0)
+        {
+            double dangle = angle - m_prev_angle[i];
+            dangle -= 2 * M_PI * std::round(dangle / (2 * M_PI));
+            double freq = m_fnom[i] + dangle / (2 * M_PI * dt);
+            m_rocof[i] = m_history[i] > 1 ? (freq - m_freq[i]) / dt : 0;
+            m_freq[i] = freq;
+            m_history[i] = 2 + (m_history[i] > 1);
+        }
+        else
+            m_history[i] = 1;
+        m_prev_angle[i] = angle;
+    }
+}
+
+void FC37118Derived::compute(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time)
+{
+    if (config_version != m_config_version)
+    {
+        m_resolve_roles(config_frame);
+        m_config_version = config_version;
+    }
+    m_gather(config_frame);
+    m_compute_sequences(ROLE_VA, SEQ_V0);
+    m_compute_sequences(ROLE_IA, SEQ_I0);
+    m_compute_powers();
+    if (m_conf->is_rocof())
+        m_compute_frequencies(frame_time);
+}
+
+static Datapoint *create_dp_phasor(const std::string &name, float re, float im)
+{
+    auto dp_mag = create_dp(DP_MAGNITUDE, (double)std::hypot(re, im));
+    auto dp_angle = create_dp(DP_ANGLE, (double)std::atan2(im, re));
+    return create_dp_list(name, new std::vector<Datapoint *>({dp_mag, dp_angle}), true);
+}
+
+Datapoint *FC37118Derived::to_datapoint(size_t station)
+{
+    const char *sequence_names[DERIVED_NB_SEQUENCES] = {DP_V0, DP_V1, DP_V2, DP_I0, DP_I1, DP_I2};
+    const char *phase_names[DERIVED_NB_POWERS] = {DP_PHASE_A, DP_PHASE_B, DP_PHASE_C, DP_TOTAL};
+
+    if (station >= m_nb_stations || !m_has_roles[station])
+        return nullptr;
+
+    auto dps = new std::vector<Datapoint *>;
+    for (int s = 0; s < DERIVED_NB_SEQUENCES; s++)
+    {
+        if ((s < SEQ_I0 && m_has_voltages[station]) || (s >= SEQ_I0 && m_has_currents[station]))
+            dps->push_back(create_dp_phasor(sequence_names[s], m_seq_re[s][station], m_seq_im[s][station]));
+    }
+
+    auto p_dps = new std::vector<Datapoint *>;
+    auto q_dps = new std::vector<Datapoint *>;
+    auto s_dps = new std::vector<Datapoint *>;
+    for (int phase = 0; phase < DERIVED_NB_POWERS; phase++)
+    {
+        bool is_available = phase == POWER_TOTAL
+                                ? m_has_voltages[station] && m_has_currents[station]
+                                : m_channels[ROLE_VA + phase][station] >= 0 && m_channels[ROLE_IA + phase][station] >= 0;
+        if (!is_available)
+            continue;
+        double p = m_p[phase][station], q = m_q[phase][station];
+        p_dps->push_back(create_dp(phase_names[phase], p));
+        q_dps->push_back(create_dp(phase_names[phase], q));
+        s_dps->push_back(create_dp(phase_names[phase], std::hypot(p, q)));
+    }
+    if (p_dps->empty())
+    {
+        delete p_dps;
+        delete q_dps;
+        delete s_dps;
+    }
+    else
+    {
+        dps->push_back(create_dp_list(DP_ACTIVE_POWER, p_dps, true));
+        dps->push_back(create_dp_list(DP_REACTIVE_POWER, q_dps, true));
+        dps->push_back(create_dp_list(DP_APPARENT_POWER, s_dps, true));
+    }
+
+    if (m_conf->is_rocof() && m_history[station] > 1)
+    {
+        dps->push_back(create_dp(DP_ANGLE_FREQUENCY, m_freq[station]));
+        if (m_history[station] > 2)
+            dps->push_back(create_dp(DP_ANGLE_ROCOF, m_rocof[station]));
+    }
+    return create_dp_list(DP_DERIVED, dps, true);
+}
@@ -0,0 +1,123 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <algorithm>
+
+#include "logger.h"
+#include "fc37118dictionary.h"
+#include "fc37118datapoint.h"
+#include "fc37118channel.h"
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static uint32_t fnv1a(uint32_t hash, const unsigned char *begin, const unsigned char *end)
+{
+    for (; begin < end; begin++)
+        hash = (hash ^ *begin) * FNV_PRIME;
+    return hash;
+}
+
+/**
+ * @brief the 24 bits scale factor of PHUNIT / ANUNIT, signed for the analogs
+ */
+static long unit_scale(unsigned int unit, bool is_signed)
+{
+    long scale = unit & 0x00FFFFFF;
+    if (is_signed && (scale & 0x00800000))
+        scale -= 0x01000000;
+    return scale;
+}
+
+static const char *phasor_type(unsigned int phunit)
+{
+    return (phunit >> 24) == 1 ? "I" : "V";
+}
+
+static const char *analog_type(unsigned int anunit)
+{
+    switch (anunit >> 24)
+    {
+    case 0:
+        return "POW";
+    case 1:
+        return "RMS";
+    case 2:
+        return "PEAK";
+    default:
+        return "USER";
+    }
+}
+
+FC37118Dictionary::FC37118Dictionary() : m_version(0)
+{
+}
+
+FC37118Dictionary::~FC37118Dictionary()
+{
+}
+
+Reading *FC37118Dictionary::update(CONFIG_Frame *config_frame, const unsigned char *frame, size_t size, const std::vector<unsigned int> &stn_filter)
+{
+    // SOC and FRACSEC (bytes 6 to 13) and CHK do not change the configuration
+    uint32_t hash = FNV_OFFSET_BASIS;
+    if (size >= 16)
+        hash = fnv1a(fnv1a(hash, frame, frame + 6), frame + 14, frame + size - 2);
+    m_version = hash;
+
+    auto station_dps = new std::vector<Datapoint *>;
+    for (size_t index = 0; index < config_frame->pmu_station_list.size(); index++)
+    {
+        auto pmu_station = config_frame->pmu_station_list[index];
+        if (!stn_filter.empty() && std::find(stn_filter.begin(), stn_filter.end(), pmu_station->IDCODE_get()) == stn_filter.end())
+            continue;
+        station_dps->push_back(m_station_to_datapoint(pmu_station, index));
+    }
+    Logger::getLogger()->info("Dictionary: configuration version %ld, %u stations", m_version, (uint)station_dps->size());
+
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_CONFIG_VERSION, m_version));
+    dps->push_back(create_dp(DP_DICT_TIME_BASE, (long)config_frame->TIME_BASE_get()));
+    dps->push_back(create_dp(DP_DICT_DATA_RATE, (long)config_frame->DATA_RATE_get()));
+    dps->push_back(create_dp_list(DP_DICT_STATIONS, station_dps, false));
+    return new Reading(std::to_string(config_frame->IDCODE_get()) + "-" DP_DICTIONARY, create_dp_list(DP_DICTIONARY, dps, true));
+}
+
+Datapoint *FC37118Dictionary::m_station_to_datapoint(PMU_Station *pmu_station, size_t index)
+{
+    auto phasor_dps = new std::vector<Datapoint *>;
+    for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+    {
+        auto phunit = pmu_station->PHUNIT_get(k);
+        auto dp_label = create_dp(DP_DICT_LABEL, pmu_station->PH_NAME_get(k));
+        auto dp_type = create_dp(DP_DICT_TYPE, std::string(phasor_type(phunit)));
+        auto dp_scale = create_dp(DP_DICT_SCALE, unit_scale(phunit, false));
+        phasor_dps->push_back(create_dp_list(DP_DICT_CHANNEL, new std::vector<Datapoint *>({dp_label, dp_type, dp_scale}), true));
+    }
+    auto analog_dps = new std::vector<Datapoint *>;
+    for (int k = 0; k < pmu_station->ANNMR_get(); k++)
+    {
+        auto anunit = pmu_station->ANUNIT_get(k);
+        auto dp_label = create_dp(DP_DICT_LABEL, pmu_station->AN_NAME_get(k));
+        auto dp_type = create_dp(DP_DICT_TYPE, std::string(analog_type(anunit)));
+        auto dp_scale = create_dp(DP_DICT_SCALE, unit_scale(anunit, true));
+        analog_dps->push_back(create_dp_list(DP_DICT_CHANNEL, new std::vector<Datapoint *>({dp_label, dp_type, dp_scale}), true));
+    }
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_STATION_INDEX, (long)index));
+    dps->push_back(create_dp(DP_DICT_IDCODE, (long)pmu_station->IDCODE_get()));
+    dps->push_back(create_dp(DP_DICT_STN, pmu_station->STN_get()));
+    dps->push_back(create_dp(DP_DICT_FORMAT, (long)pmu_station->FORMAT_get()));
+    dps->push_back(create_dp(DP_DICT_FNOM, (long)station_fnom(pmu_station)));
+    dps->push_back(create_dp(DP_DICT_CFGCNT, (long)pmu_station->CFGCNT_get()));
+    dps->push_back(create_dp_list(DP_DICT_PHASORS, phasor_dps, false));
+    dps->push_back(create_dp_list(DP_DICT_ANALOGS, analog_dps, false));
+    return create_dp_list(DP_DICT_STATION, dps, true);
+}
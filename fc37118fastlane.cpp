@@ -0,0 +1,122 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "fc37118fastlane.h"
+#include "fc37118capture.h"
+#include "fc37118channel.h"
+
+FC37118FastLane::FC37118FastLane() : m_conf(nullptr),
+                                     m_nb_flagged_frames(0)
+{
+    m_clear_stats();
+}
+
+FC37118FastLane::~FC37118FastLane()
+{
+}
+
+void FC37118FastLane::configure(FC37118FastLaneConf *conf)
+{
+    m_conf = conf;
+    m_flagged.clear();
+    m_flagged_stations.clear();
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    m_clear_stats();
+    m_next_report = std::chrono::steady_clock::now() + std::chrono::seconds(is_enabled() ? m_conf->get_report_period() : 0);
+}
+
+bool FC37118FastLane::classify(CONFIG_Frame *config_frame, const std::vector<unsigned int> &stn_filter)
+{
+    m_flagged.clear();
+    m_flagged_stations.clear();
+    for (auto pmu_station : config_frame->pmu_station_list)
+    {
+        if (!stn_filter.empty() && std::find(stn_filter.begin(), stn_filter.end(), pmu_station->IDCODE_get()) == stn_filter.end())
+            continue;
+        bool is_flagged = (pmu_station->STAT_get() & m_conf->get_stat_mask()) != 0 ||
+                          (m_conf->get_freq_deviation() > 0 && std::abs(station_frequency(pmu_station) - station_fnom(pmu_station)) > m_conf->get_freq_deviation()) ||
+                          (m_conf->get_rocof() > 0 && std::abs(station_rocof(pmu_station)) > m_conf->get_rocof());
+        if (is_flagged)
+            m_flagged_stations.insert(pmu_station->IDCODE_get());
+    }
+    if (m_flagged_stations.empty())
+        return false;
+    m_flagged = m_flagged_stations;
+    m_flagged.insert(config_frame->IDCODE_get());
+    m_nb_flagged_frames++;
+    return true;
+}
+
+void FC37118FastLane::record(FC37118Lane lane, uint64_t arrival_ns)
+{
+    if (m_conf->get_report_period() == 0 || arrival_ns == 0)
+        return;
+    uint64_t now_ns = capture_clock_ns();
+    double latency_us = now_ns > arrival_ns ? (now_ns - arrival_ns) / 1000.0 : 0;
+
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    auto &stats = m_stats[lane == FC37118Lane::FAST ? 0 : 1];
+    stats.count++;
+    stats.sum_us += latency_us;
+    stats.max_us = std::max(stats.max_us, latency_us);
+    int bucket = latency_us < 1 ? 0 : std::min(FAST_LANE_LATENCY_BUCKETS - 1, (int)std::log2(latency_us) + 1);
+    stats.buckets[bucket]++;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_next_report)
+        return;
+    m_report();
+    m_clear_stats();
+    m_next_report = now + std::chrono::seconds(m_conf->get_report_period());
+}
+
+void FC37118FastLane::m_clear_stats()
+{
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+/**
+ * @brief log the latency of each lane over the period, the percentiles being the upper bounds of the histogram buckets
+ */
+void FC37118FastLane::m_report()
+{
+    static const char *names[] = {"fast", "bulk"};
+    Logger::getLogger()->info("Fast lane: %lu flagged frames since start", m_nb_flagged_frames.load());
+    for (int lane = 0; lane < 2; lane++)
+    {
+        auto &stats = m_stats[lane];
+        if (stats.count == 0)
+        {
+            Logger::getLogger()->info("  %s lane: no reading", names[lane]);
+            continue;
+        }
+        double percentiles[2] = {0, 0};
+        const double ranks[2] = {0.5, 0.99};
+        for (int p = 0; p < 2; p++)
+        {
+            unsigned long cumulated = 0;
+            for (int bucket = 0; bucket < FAST_LANE_LATENCY_BUCKETS; bucket++)
+            {
+                cumulated += stats.buckets[bucket];
+                if (cumulated >= std::ceil(ranks[p] * stats.count))
+                {
+                    percentiles[p] = std::min(stats.max_us, std::ldexp(1.0, bucket));
+                    break;
+                }
+            }
+        }
+        Logger::getLogger()->info("  %s lane: %lu readings, latency mean %.0f us, p50 < %.0f us, p99 < %.0f us, max %.0f us",
+                                  names[lane], stats.count, stats.sum_us / stats.count, percentiles[0], percentiles[1], stats.max_us);
+    }
+}
@@ -0,0 +1,185 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "fc37118framereader.h"
+
+#define CRC_SLICES 8
+
+/**
+ * @brief crc_tables[k][b]: crc contribution of byte b followed by k zero bytes
+ */
+struct CrcTables
+{
+    uint16_t tables[CRC_SLICES][256];
+
+    CrcTables()
+    {
+        for (int b = 0; b < 256; b++)
+        {
+            uint16_t crc = b << 8;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+            tables[0][b] = crc;
+        }
+        for (int k = 1; k < CRC_SLICES; k++)
+        {
+            for (int b = 0; b < 256; b++)
+                tables[k][b] = (tables[k - 1][b] << 8) ^ tables[0][tables[k - 1][b] >> 8];
+        }
+    }
+};
+
+static const CrcTables crc_tables;
+
+uint16_t crc_ccitt(const unsigned char *data, size_t size)
+{
+    auto &t = crc_tables.tables;
+    uint16_t crc = 0xFFFF;
+    while (size >= CRC_SLICES)
+    {
+        crc = t[7][data[0] ^ (crc >> 8)] ^ t[6][data[1] ^ (crc & 0xFF)] ^
+              t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += CRC_SLICES;
+        size -= CRC_SLICES;
+    }
+    while (size-- > 0)
+        crc = (crc << 8) ^ t[0][(crc >> 8) ^ *data++];
+    return crc;
+}
+
+size_t expected_data_frame_size(CONFIG_Frame *config_frame)
+{
+    size_t size = C37118_MIN_FRAME_SIZE;
+    for (auto pmu_station : config_frame->pmu_station_list)
+    {
+        size += 2; // STAT
+        size += pmu_station->PHNMR_get() * (pmu_station->FORMAT_PHASOR_TYPE_get() ? 8 : 4);
+        size += 2 * (pmu_station->FORMAT_FREQ_TYPE_get() ? 4 : 2); // FREQ, DFREQ
+        size += pmu_station->ANNMR_get() * (pmu_station->FORMAT_ANALOG_TYPE_get() ? 4 : 2);
+        size += pmu_station->DGNMR_get() * 2;
+    }
+    return size;
+}
+
+FC37118FrameReader::FC37118FrameReader() : m_buffer(FRAME_READER_BUFFER_SIZE),
+                                           m_begin(0),
+                                           m_end(0),
+                                           m_nb_crc_errors(0),
+                                           m_nb_skipped_bytes(0),
+                                           m_external(nullptr),
+                                           m_external_begin(0),
+                                           m_external_end(0)
+{
+}
+
+FC37118FrameReader::~FC37118FrameReader() {}
+
+void FC37118FrameReader::reset()
+{
+    m_begin = 0;
+    m_end = 0;
+    m_external = nullptr;
+}
+
+void FC37118FrameReader::feed(const unsigned char *data, size_t size)
+{
+    if (m_begin == m_end && m_external == nullptr)
+    {
+        m_begin = m_end = 0;
+        m_external = data;
+        m_external_begin = 0;
+        m_external_end = size;
+        return;
+    }
+
+    // a frame is pending in the reader buffer: complete it there
+    size_t copied = std::min(size, write_space());
+    memcpy(write_ptr(), data, copied);
+    commit(copied);
+    m_nb_skipped_bytes += size - copied;
+}
+
+/**
+ * @brief drop size bytes, then the bytes up to the next SYNC byte
+ */
+void FC37118FrameReader::m_skip(const unsigned char *data, size_t *begin, size_t end, size_t size)
+{
+    size_t from = *begin + size;
+    auto sync = (const unsigned char *)memchr(data + from, C37118_SYNC_BYTE, end - from);
+    size_t next = sync == nullptr ? end : sync - data;
+    m_nb_skipped_bytes += next - *begin;
+    *begin = next;
+}
+
+bool FC37118FrameReader::m_parse(const unsigned char *data, size_t *begin, size_t end, unsigned char **frame, size_t *size)
+{
+    while (end - *begin >= 4)
+    {
+        const unsigned char *start = data + *begin;
+        // SYNC: 0xAA, frame type 0 to 5, version 1 to 3
+        if (start[0] != C37118_SYNC_BYTE || frame_type(start) > 5 || (start[1] & 0x0F) == 0 || (start[1] & 0x0F) > 3)
+        {
+            m_skip(data, begin, end, 1);
+            continue;
+        }
+        size_t frame_size = (start[2] << 8) | start[3];
+        if (frame_size < C37118_MIN_FRAME_SIZE)
+        {
+            m_skip(data, begin, end, 1);
+            continue;
+        }
+        if (end - *begin < frame_size)
+            return false;
+
+        uint16_t chk = (start[frame_size - 2] << 8) | start[frame_size - 1];
+        if (crc_ccitt(start, frame_size - 2) != chk)
+        {
+            m_nb_crc_errors++;
+            m_skip(data, begin, end, 1);
+            continue;
+        }
+        *begin += frame_size;
+        *frame = (unsigned char *)start;
+        *size = frame_size;
+        return true;
+    }
+    return false;
+}
+
+bool FC37118FrameReader::next(unsigned char **frame, size_t *size)
+{
+    if (m_external != nullptr)
+    {
+        if (m_parse(m_external, &m_external_begin, m_external_end, frame, size))
+            return true;
+
+        // the frame split across two buffers is completed in the reader buffer
+        m_begin = 0;
+        m_end = m_external_end - m_external_begin;
+        memcpy(m_buffer.data(), m_external + m_external_begin, m_end);
+        m_external = nullptr;
+        return false;
+    }
+
+    if (m_parse(m_buffer.data(), &m_begin, m_end, frame, size))
+        return true;
+
+    // keep the partial frame at the beginning of the buffer so that a complete frame always fits
+    if (m_begin > 0)
+    {
+        memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+    return false;
+}
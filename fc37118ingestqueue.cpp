@@ -0,0 +1,215 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include "fc37118ingestqueue.h"
+
+static size_t count_datapoints(Datapoint *dp)
+{
+    size_t count = 1;
+    auto &data = dp->getData();
+    if (data.getType() == DatapointValue::T_DP_DICT || data.getType() == DatapointValue::T_DP_LIST)
+    {
+        for (auto child : *data.getDpVec())
+            count += count_datapoints(child);
+    }
+    return count;
+}
+
+size_t estimate_reading_size(Reading *reading)
+{
+    size_t count = 0;
+    for (auto dp : reading->getReadingData())
+        count += count_datapoints(dp);
+    return sizeof(Reading) + count * DATAPOINT_SIZE_ESTIMATE;
+}
+
+FC37118IngestQueue::FC37118IngestQueue() : m_conf(nullptr),
+                                           m_memory(0),
+                                           m_stopping(false),
+                                           m_consumer(nullptr),
+                                           m_period_max_depth(0)
+{
+}
+
+FC37118IngestQueue::~FC37118IngestQueue()
+{
+    stop();
+}
+
+void FC37118IngestQueue::start(FC37118QueueConf *conf, IngestFunction ingest)
+{
+    stop();
+    m_conf = conf;
+    m_ingest = ingest;
+    m_stopping = false;
+    auto priority_idcodes = m_conf->get_priority_idcodes();
+    m_priority_idcodes = std::set<unsigned short>(priority_idcodes.begin(), priority_idcodes.end());
+    m_nth_counters.clear();
+    m_period_drops.clear();
+    m_total_drops.clear();
+    m_period_max_depth = 0;
+    m_consumer = new std::thread(&FC37118IngestQueue::m_consume, this);
+    Logger::getLogger()->info("Ingest queue started: %u readings, %u kB max", m_conf->get_max_readings(), (uint)(m_conf->get_max_memory() / 1024));
+}
+
+void FC37118IngestQueue::stop()
+{
+    if (m_consumer == nullptr)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_consumer->join();
+    delete m_consumer;
+    m_consumer = nullptr;
+
+    if (!m_entries.empty())
+        Logger::getLogger()->info("Ingest queue stopped, %u queued readings discarded", (uint)m_entries.size());
+    for (auto &entry : m_entries)
+        delete entry.reading.reading;
+    m_entries.clear();
+    m_memory = 0;
+}
+
+bool FC37118IngestQueue::m_is_full(size_t size)
+{
+    return m_entries.size() >= m_conf->get_max_readings() ||
+           (!m_entries.empty() && m_memory + size > m_conf->get_max_memory());
+}
+
+bool FC37118IngestQueue::m_is_overloaded()
+{
+    return m_entries.size() >= m_conf->get_max_readings() / 2 ||
+           m_memory >= m_conf->get_max_memory() / 2;
+}
+
+void FC37118IngestQueue::m_drop(const Entry &entry)
+{
+    m_period_drops[entry.reading.idcode]++;
+    m_total_drops[entry.reading.idcode]++;
+    delete entry.reading.reading;
+}
+
+/**
+ * @brief drop queued readings according to the policy until entry fits in the queue
+ *
+ * @return true - entry can be queued
+ * @return false - entry shall be dropped
+ */
+bool FC37118IngestQueue::m_make_room(const Entry &entry)
+{
+    while (m_is_full(entry.size))
+    {
+        auto victim = m_entries.begin();
+        switch (m_conf->get_policy())
+        {
+        case QueuePolicy::DROP_NEWEST:
+            return false;
+        case QueuePolicy::PRIORITY:
+            victim = std::find_if(m_entries.begin(), m_entries.end(), [](const Entry &e)
+                                  { return !e.is_priority; });
+            if (victim == m_entries.end())
+            {
+                if (!entry.is_priority)
+                    return false;
+                victim = m_entries.begin();
+            }
+            break;
+        default:
+            break;
+        }
+        m_memory -= victim->size;
+        m_drop(*victim);
+        m_entries.erase(victim);
+    }
+    return true;
+}
+
+void FC37118IngestQueue::push(const FC37118Reading &reading)
+{
+    Entry entry = {reading, estimate_reading_size(reading.reading), m_priority_idcodes.count(reading.idcode) > 0};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool keep = true;
+        if (m_conf->get_policy() == QueuePolicy::KEEP_NTH && m_is_overloaded())
+            keep = m_nth_counters[reading.idcode]++ % m_conf->get_keep_nth() == 0;
+        else
+            m_nth_counters[reading.idcode] = 0;
+
+        if (keep && m_make_room(entry))
+        {
+            m_entries.push_back(entry);
+            m_memory += entry.size;
+            m_period_max_depth = std::max(m_period_max_depth, m_entries.size());
+        }
+        else
+            m_drop(entry);
+    }
+    m_cv.notify_one();
+}
+
+void FC37118IngestQueue::m_consume()
+{
+    bool is_reporting = m_conf->get_report_period() > 0;
+    auto period = std::chrono::seconds(is_reporting ? m_conf->get_report_period() : 3600);
+    auto next_report = std::chrono::steady_clock::now() + period;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping)
+    {
+        m_cv.wait_until(lock, next_report, [this]
+                        { return m_stopping || !m_entries.empty(); });
+
+        if (std::chrono::steady_clock::now() >= next_report)
+        {
+            if (is_reporting)
+                m_report();
+            next_report += period;
+        }
+
+        // the drain stops when the report is due, so that it is not delayed by a queue that never empties
+        while (!m_stopping && !m_entries.empty() && std::chrono::steady_clock::now() < next_report)
+        {
+            Entry entry = m_entries.front();
+            m_entries.pop_front();
+            m_memory -= entry.size;
+            lock.unlock();
+            m_ingest(entry.reading);
+            delete entry.reading.reading;
+            lock.lock();
+        }
+    }
+}
+
+/**
+ * @brief log the drops of the elapsed period, called with m_mutex held
+ */
+void FC37118IngestQueue::m_report()
+{
+    if (m_period_drops.empty())
+    {
+        Logger::getLogger()->debug("Ingest queue: no drop, max depth %u", (uint)m_period_max_depth);
+    }
+    else
+    {
+        unsigned long total = 0;
+        for (auto &drops : m_period_drops)
+            total += drops.second;
+        Logger::getLogger()->warn("Ingest queue overloaded: %lu readings dropped in the last %u s, max depth %u",
+                                  total, m_conf->get_report_period(), (uint)m_period_max_depth);
+        for (auto &drops : m_period_drops)
+            Logger::getLogger()->warn("  IDCODE %u: %lu dropped, %lu since start",
+                                      drops.first, drops.second, m_total_drops[drops.first]);
+    }
+    m_period_drops.clear();
+    m_period_max_depth = 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <algorithm>
+
+#include "fc37118loadshedding.h"
+#include "fc37118datapoint.h"
+
+FC37118LoadShedding::FC37118LoadShedding() : m_conf(nullptr),
+                                             m_level(0),
+                                             m_nb_frames(0),
+                                             m_config_version(0),
+                                             m_budget_us(0),
+                                             m_window_us(0),
+                                             m_window_frames(0),
+                                             m_window_output_us(0),
+                                             m_window_output_frames(0),
+                                             m_step_output_us(0),
+                                             m_overload_s(0),
+                                             m_recovery_s(0)
+{
+}
+
+FC37118LoadShedding::~FC37118LoadShedding()
+{
+}
+
+void FC37118LoadShedding::configure(FC37118LoadSheddingConf *conf)
+{
+    m_conf = conf;
+    m_levels = is_enabled() ? m_conf->get_levels() : std::vector<FC37118LoadLevelConf>();
+    m_level = 0;
+    m_nb_frames = 0;
+    m_config_version = 0;
+    m_cost_ratios.assign(m_levels.size() + 1, 1);
+    m_step_output_us = 0;
+    m_overload_s = 0;
+    m_recovery_s = 0;
+    m_reset_window();
+}
+
+bool FC37118LoadShedding::is_output_frame()
+{
+    return m_nb_frames++ % get_level().decimation == 0;
+}
+
+Reading *FC37118LoadShedding::frame_done(CONFIG_Frame *config_frame, unsigned long config_version, bool is_output, std::chrono::steady_clock::duration elapsed)
+{
+    if (config_version != m_config_version)
+    {
+        // DATA_RATE > 0: frames per second, < 0: seconds per frame
+        short data_rate = config_frame->DATA_RATE_get();
+        double period_s = data_rate > 0 ? 1.0 / data_rate : (data_rate < 0 ? -data_rate : 1.0);
+        m_budget_us = period_s * 1e6 * m_conf->get_budget_percent() / 100;
+        m_config_version = config_version;
+        m_overload_s = 0;
+        m_recovery_s = 0;
+        m_cost_ratios.assign(m_levels.size() + 1, 1);
+        m_step_output_us = 0;
+        m_reset_window();
+    }
+
+    double elapsed_us = std::chrono::duration<double, std::micro>(elapsed).count();
+    m_window_us += elapsed_us;
+    m_window_frames++;
+    if (is_output)
+    {
+        m_window_output_us += elapsed_us;
+        m_window_output_frames++;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_window_end)
+        return nullptr;
+
+    double frame_time_us = m_window_us / m_window_frames;
+    // the frames that are not output still cost their decoding and the analysis stages
+    size_t nb_skipped = m_window_frames - m_window_output_frames;
+    double skipped_us = nb_skipped > 0 ? (m_window_us - m_window_output_us) / nb_skipped : 0;
+    double output_us = m_window_output_frames > 0 ? m_window_output_us / m_window_output_frames : frame_time_us;
+    if (m_step_output_us > 0 && m_window_output_frames > 0)
+    {
+        m_cost_ratios[m_level] = output_us > 0 ? std::max(1.0, m_step_output_us / output_us) : 1;
+        m_step_output_us = 0;
+    }
+    m_reset_window();
+
+    // processing time of the previous level, the current one at level 0
+    double recovery_time_us = frame_time_us;
+    if (m_level > 0)
+    {
+        double previous_output_us = output_us * m_cost_ratios[m_level];
+        recovery_time_us = skipped_us + (previous_output_us - skipped_us) / m_decimation(m_level - 1);
+    }
+
+    if (frame_time_us > m_budget_us)
+    {
+        m_overload_s += LOAD_SHEDDING_WINDOW_S;
+        m_recovery_s = 0;
+    }
+    else if (recovery_time_us < m_budget_us * m_conf->get_recovery_percent() / 100)
+    {
+        m_recovery_s += LOAD_SHEDDING_WINDOW_S;
+        m_overload_s = 0;
+    }
+    else
+    {
+        m_overload_s = 0;
+        m_recovery_s = 0;
+    }
+
+    if (m_overload_s >= m_conf->get_overload_s() && m_level < m_levels.size())
+    {
+        m_step_output_us = output_us;
+        return m_change_level(m_level + 1, config_frame->IDCODE_get(), frame_time_us);
+    }
+    if (m_recovery_s >= m_conf->get_recovery_s() && m_level > 0)
+    {
+        m_step_output_us = 0;
+        return m_change_level(m_level - 1, config_frame->IDCODE_get(), recovery_time_us);
+    }
+    return nullptr;
+}
+
+void FC37118LoadShedding::m_reset_window()
+{
+    m_window_end = std::chrono::steady_clock::now() + std::chrono::seconds(LOAD_SHEDDING_WINDOW_S);
+    m_window_us = 0;
+    m_window_frames = 0;
+    m_window_output_us = 0;
+    m_window_output_frames = 0;
+}
+
+Reading *FC37118LoadShedding::m_change_level(size_t level, unsigned short idcode, double frame_time_us)
+{
+    if (level > m_level)
+        Logger::getLogger()->warn("Load shedding: %.0f us per frame for a budget of %.0f us, level %u -> %u",
+                                  frame_time_us, m_budget_us, (uint)m_level, (uint)level);
+    else
+        Logger::getLogger()->info("Load shedding: %.0f us per frame for a budget of %.0f us, level %u -> %u",
+                                  frame_time_us, m_budget_us, (uint)m_level, (uint)level);
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_SHED_LEVEL, (long)level));
+    dps->push_back(create_dp(DP_SHED_PREVIOUS_LEVEL, (long)m_level));
+    dps->push_back(create_dp(DP_SHED_FRAME_TIME_US, frame_time_us));
+    dps->push_back(create_dp(DP_SHED_BUDGET_US, m_budget_us));
+    m_level = level;
+    m_nb_frames = 0;
+    m_overload_s = 0;
+    m_recovery_s = 0;
+    return new Reading(std::to_string(idcode) + "-" DP_LOAD_SHEDDING, create_dp_list(DP_LOAD_SHEDDING, dps, true));
+}
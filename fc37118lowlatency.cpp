@@ -0,0 +1,140 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include "fc37118lowlatency.h"
+#include "fc37118capture.h"
+#include "fc37118workerpool.h"
+
+FC37118LowLatency::FC37118LowLatency() : m_conf(nullptr),
+                                         m_kernel_timestamps(false)
+{
+}
+
+FC37118LowLatency::~FC37118LowLatency() {}
+
+void FC37118LowLatency::configure(FC37118LowLatencyConf *conf)
+{
+    m_conf = conf;
+    m_failed_settings.clear();
+    m_kernel_timestamps = false;
+}
+
+bool FC37118LowLatency::m_check(bool is_ok, const std::string &setting)
+{
+    if (is_ok)
+        return true;
+    std::lock_guard<std::mutex> lock(m_failed_settings_mutex);
+    if (m_failed_settings.insert(setting).second)
+        Logger::getLogger()->warn("Low latency: unable to set " + setting + ": " + strerror(errno));
+    return false;
+}
+
+void FC37118LowLatency::apply_thread()
+{
+    if (m_conf == nullptr)
+        return;
+
+    if (!m_conf->get_cpus().empty())
+        m_check(pin_thread(pthread_self(), m_conf->get_cpus()), LL_CPUS);
+
+    if (m_conf->get_sched_fifo_priority() > 0)
+    {
+        struct sched_param param;
+        param.sched_priority = m_conf->get_sched_fifo_priority();
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        errno = error;
+        m_check(error == 0, LL_SCHED_FIFO_PRIORITY);
+    }
+}
+
+void FC37118LowLatency::apply_socket(int sockfd)
+{
+    if (m_conf == nullptr)
+        return;
+    int one = 1;
+
+    if (m_conf->get_rcvbuf() > 0)
+    {
+        int rcvbuf = m_conf->get_rcvbuf();
+        m_check(setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) == 0, LL_RCVBUF_KB);
+    }
+
+    if (m_conf->is_tcp_nodelay())
+        m_check(setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == 0, LL_TCP_NODELAY);
+
+    if (m_conf->is_tcp_quickack())
+        m_check(setsockopt(sockfd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one)) == 0, LL_TCP_QUICKACK);
+
+    if (m_conf->get_busy_poll_us() > 0)
+    {
+#ifdef SO_BUSY_POLL
+        int busy_poll = m_conf->get_busy_poll_us();
+        m_check(setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll)) == 0, LL_BUSY_POLL_US);
+#else
+        errno = ENOTSUP;
+        m_check(false, LL_BUSY_POLL_US);
+#endif
+    }
+
+    if (m_conf->is_kernel_timestamps())
+        m_kernel_timestamps = m_check(setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0, LL_KERNEL_TIMESTAMPS);
+}
+
+int FC37118LowLatency::read(int sockfd, unsigned char *buffer, size_t size, uint64_t *arrival_ns)
+{
+    int n;
+    if (!m_kernel_timestamps)
+    {
+        n = ::read(sockfd, buffer, size);
+        *arrival_ns = capture_clock_ns();
+    }
+    else
+    {
+        char control[CMSG_SPACE(sizeof(struct timespec))];
+        struct iovec iov = {buffer, size};
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        n = recvmsg(sockfd, &msg, 0);
+        *arrival_ns = 0;
+        for (auto cmsg = CMSG_FIRSTHDR(&msg); n > 0 && cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+            {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                *arrival_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+            }
+        }
+        if (*arrival_ns == 0)
+            *arrival_ns = capture_clock_ns();
+    }
+
+    // quick ack mode is not permanent, it has to be re-armed after each read
+    if (n > 0 && m_conf != nullptr && m_conf->is_tcp_quickack())
+    {
+        int one = 1;
+        m_check(setsockopt(sockfd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one)) == 0, LL_TCP_QUICKACK);
+    }
+    return n;
+}
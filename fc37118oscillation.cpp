@@ -0,0 +1,230 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cmath>
+
+#include "fc37118.h"
+#include "fc37118oscillation.h"
+#include "fc37118datapoint.h"
+
+FC37118Oscillation::FC37118Oscillation() : m_conf(nullptr),
+                                           m_config_version(0),
+                                           m_decimation(1),
+                                           m_sample_rate(0),
+                                           m_window(0),
+                                           m_first_bin(0),
+                                           m_last_bin(0),
+                                           m_next_emit(0),
+                                           m_stream_idcode(0)
+{
+}
+
+FC37118Oscillation::~FC37118Oscillation() {}
+
+void FC37118Oscillation::configure(FC37118OscillationConf *conf)
+{
+    m_conf = conf;
+    m_config_version = 0;
+    m_channels.clear();
+}
+
+/**
+ * @brief size the window and the bins from the data rate, and resolve the channels
+ */
+void FC37118Oscillation::m_setup(CONFIG_Frame *config_frame)
+{
+    // DATA_RATE < 0 means one frame every -DATA_RATE seconds, 0 (possible with SENDER_HARD_CONFIG) is taken as one per second
+    short rate = config_frame->DATA_RATE_get();
+    double data_rate = rate > 0 ? rate : (rate < 0 ? 1.0 / -rate : 1.0);
+    m_decimation = std::max(1, (int)std::lround(data_rate / m_conf->get_sample_rate()));
+    m_sample_rate = data_rate / m_decimation;
+    m_window = std::max<size_t>(8, std::lround(m_conf->get_window_s() * m_sample_rate));
+
+    // bin 0 and 1 are kept out of the band so that the offset of the signal does not leak through the Hann window
+    m_first_bin = std::max(2, (int)std::ceil(m_conf->get_min_freq() * m_window / m_sample_rate));
+    m_last_bin = std::min((int)m_window / 2 - 2, (int)std::floor(m_conf->get_max_freq() * m_window / m_sample_rate));
+    m_twiddles.clear();
+    m_channels.clear();
+    m_stream_idcode = config_frame->IDCODE_get();
+    m_next_emit = 0;
+    if (m_last_bin < m_first_bin)
+    {
+        // the band holds no bin at this resolution: no mode can be estimated
+        Logger::getLogger()->error(OSCILLATION ": no bin between %f and %f Hz with a %u samples window at %f Hz, disabled until the configuration changes",
+                                   m_conf->get_min_freq(), m_conf->get_max_freq(), (uint)m_window, m_sample_rate);
+        return;
+    }
+    for (int k = m_first_bin - 1; k <= m_last_bin + 1; k++)
+        m_twiddles.push_back(std::polar(1.0, 2 * M_PI * k / m_window));
+
+    for (auto &channel_conf : m_conf->get_channels())
+    {
+        Channel channel;
+        channel.conf = channel_conf;
+        if (!channel.ref.resolve(config_frame, channel_conf.idcode, channel_conf.channel, channel_conf.quantity == OSC_QUANTITY_ANG))
+        {
+            Logger::getLogger()->warn(OSCILLATION ": channel " + channel_conf.channel + " of station %u not found", channel_conf.idcode);
+            continue;
+        }
+        channel.label = channel.ref.label(config_frame);
+        channel.accumulator = 0;
+        channel.nb_accumulated = 0;
+        channel.previous_raw = 0;
+        channel.unwrap_offset = 0;
+        channel.samples.assign(m_window, 0);
+        channel.position = 0;
+        channel.nb_samples = 0;
+        channel.since_refresh = 0;
+        channel.bins.assign(m_twiddles.size(), 0);
+        channel.has_previous_mode = false;
+        channel.previous_bin = 0;
+        channel.previous_amplitude = 0;
+        channel.previous_time = 0;
+        m_channels.push_back(channel);
+    }
+    Logger::getLogger()->info(OSCILLATION ": %u channels, %u samples window at %f Hz, bins %i to %i",
+                              (uint)m_channels.size(), (uint)m_window, m_sample_rate, m_first_bin, m_last_bin);
+}
+
+/**
+ * @brief recompute the bins from the samples, to cancel the rounding drift of the sliding updates
+ */
+void FC37118Oscillation::m_refresh(Channel &channel)
+{
+    for (size_t b = 0; b < channel.bins.size(); b++)
+    {
+        int k = m_first_bin - 1 + (int)b;
+        std::complex<double> sum = 0;
+        for (size_t m = 0; m < m_window; m++)
+            sum += channel.samples[(channel.position + m) % m_window] * std::polar(1.0, -2 * M_PI * k * (double)m / m_window);
+        channel.bins[b] = sum;
+    }
+    channel.since_refresh = 0;
+}
+
+/**
+ * @brief sliding DFT update: X_k(n) = (X_k(n-1) + x(n) - x(n-N)).exp(j2pi.k/N)
+ */
+void FC37118Oscillation::m_push_sample(Channel &channel, double sample)
+{
+    double delta = sample - channel.samples[channel.position];
+    channel.samples[channel.position] = sample;
+    channel.position = (channel.position + 1) % m_window;
+    if (channel.nb_samples < m_window)
+        channel.nb_samples++;
+
+    if (++channel.since_refresh >= m_window)
+    {
+        m_refresh(channel);
+        return;
+    }
+    for (size_t b = 0; b < channel.bins.size(); b++)
+        channel.bins[b] = (channel.bins[b] + delta) * m_twiddles[b];
+}
+
+Datapoint *FC37118Oscillation::m_estimate_mode(Channel &channel, double time)
+{
+    // Hann window applied in the frequency domain: Xh_k = 0.5 X_k - 0.25 (X_k-1 + X_k+1)
+    std::vector<double> magnitudes(channel.bins.size(), 0);
+    for (size_t b = 1; b + 1 < channel.bins.size(); b++)
+        magnitudes[b] = std::abs(0.5 * channel.bins[b] - 0.25 * (channel.bins[b - 1] + channel.bins[b + 1]));
+
+    size_t peak = 1;
+    for (size_t b = 2; b + 1 < channel.bins.size(); b++)
+    {
+        if (magnitudes[b] > magnitudes[peak])
+            peak = b;
+    }
+
+    // quadratic interpolation of the log magnitudes around the peak
+    double offset = 0;
+    if (peak > 1 && peak + 2 < channel.bins.size() && magnitudes[peak - 1] > 0 && magnitudes[peak + 1] > 0)
+    {
+        double left = std::log(magnitudes[peak - 1]), center = std::log(magnitudes[peak]), right = std::log(magnitudes[peak + 1]);
+        double denominator = 2 * center - left - right;
+        if (denominator > 0)
+            offset = 0.5 * (right - left) / denominator;
+    }
+    int bin = m_first_bin - 1 + (int)peak;
+    double frequency = (bin + offset) * m_sample_rate / m_window;
+    double amplitude = 4 * magnitudes[peak] / m_window;
+
+    auto dps = new std::vector<Datapoint *>;
+    dps->push_back(create_dp(DP_IDCODE, (long)channel.conf.idcode));
+    dps->push_back(create_dp(DP_LABEL, channel.label));
+    dps->push_back(create_dp(DP_MODE_FREQUENCY, frequency));
+    dps->push_back(create_dp(DP_MODE_AMPLITUDE, amplitude));
+
+    // the windowed amplitude of x(t) = A.exp(-sigma.t).cos(wt) decays as exp(-sigma.t)
+    if (channel.has_previous_mode && std::abs(bin - channel.previous_bin) <= 1 && amplitude > 0 && time > channel.previous_time)
+    {
+        double sigma = std::log(channel.previous_amplitude / amplitude) / (time - channel.previous_time);
+        double omega = 2 * M_PI * frequency;
+        dps->push_back(create_dp(DP_MODE_DAMPING, sigma / std::sqrt(sigma * sigma + omega * omega)));
+    }
+    channel.has_previous_mode = amplitude > 0;
+    channel.previous_bin = bin;
+    channel.previous_amplitude = amplitude;
+    channel.previous_time = time;
+
+    return create_dp_list(DP_MODE, dps, true);
+}
+
+Reading *FC37118Oscillation::update(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time)
+{
+    if (config_version != m_config_version)
+    {
+        m_setup(config_frame);
+        m_config_version = config_version;
+    }
+
+    for (auto &channel : m_channels)
+    {
+        double raw = channel.ref.value(config_frame);
+        if (channel.ref.kind == ChannelKind::PHASOR_ANGLE)
+        {
+            double delta = raw - channel.previous_raw;
+            channel.unwrap_offset -= 2 * M_PI * std::round(delta / (2 * M_PI));
+            channel.previous_raw = raw;
+            raw += channel.unwrap_offset;
+        }
+        channel.accumulator += raw;
+        if (++channel.nb_accumulated == m_decimation)
+        {
+            m_push_sample(channel, channel.accumulator / m_decimation);
+            channel.accumulator = 0;
+            channel.nb_accumulated = 0;
+        }
+    }
+
+    double period = m_conf->get_emit_period_s();
+    if (frame_time < m_next_emit)
+        return nullptr;
+    bool is_first = m_next_emit == 0;
+    m_next_emit = (std::floor(frame_time / period) + 1) * period;
+    if (is_first)
+        return nullptr;
+
+    auto mode_dps = new std::vector<Datapoint *>;
+    for (auto &channel : m_channels)
+    {
+        if (channel.nb_samples == m_window)
+            mode_dps->push_back(m_estimate_mode(channel, frame_time));
+    }
+    if (mode_dps->empty())
+    {
+        delete mode_dps;
+        return nullptr;
+    }
+    auto dp_soc = create_dp(DP_SOC, (long)frame_time);
+    auto dp_modes = create_dp_list(DP_MODES, mode_dps, false);
+    auto dp_oscillation = create_dp_list(DP_OSCILLATION, new std::vector<Datapoint *>({dp_soc, dp_modes}), true);
+    return new Reading(std::to_string(m_stream_idcode) + "-" + DP_OSCILLATION, dp_oscillation);
+}
@@ -0,0 +1,154 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include "fc37118redundancy.h"
+
+/**
+ * @brief frame time comparable across frames: SOC and the 24 bits fraction of FRACSEC
+ */
+static inline uint64_t frame_time_key(uint32_t soc, uint32_t fracsec)
+{
+    return ((uint64_t)soc << 24) | (fracsec & 0x00FFFFFF);
+}
+
+FC37118Redundancy::FC37118Redundancy() : m_next_slot(0),
+                                         m_nb_entries(0),
+                                         m_time_base(1000000),
+                                         m_nb_late(0),
+                                         m_nb_resets(0),
+                                         m_report_period(60)
+{
+}
+
+FC37118Redundancy::~FC37118Redundancy() {}
+
+void FC37118Redundancy::configure(FC37118RedundancyConf *conf, const std::vector<std::string> &path_names)
+{
+    m_paths.clear();
+    m_index.clear();
+    m_window.clear();
+    m_next_slot = 0;
+    m_nb_entries = 0;
+    m_timelines.clear();
+    m_nb_late = 0;
+    m_nb_resets = 0;
+    if (!conf->is_enabled())
+        return;
+
+    for (auto &name : path_names)
+        m_paths.push_back({name, 0, 0, 0, 0, 0.0, 0});
+    m_window.resize(conf->get_window_frames());
+    m_index.reserve(conf->get_window_frames() * 2);
+    m_report_period = std::chrono::seconds(conf->get_report_period());
+    m_last_report = std::chrono::steady_clock::now();
+}
+
+bool FC37118Redundancy::first_arrival(size_t path, const unsigned char *frame, uint64_t arrival_ns)
+{
+    uint16_t idcode = (frame[4] << 8) | frame[5];
+    uint32_t soc = ((uint32_t)frame[6] << 24) | (frame[7] << 16) | (frame[8] << 8) | frame[9];
+    uint32_t fracsec = ((uint32_t)frame[10] << 24) | (frame[11] << 16) | (frame[12] << 8) | frame[13];
+    uint64_t key = frame_time_key(soc, fracsec) ^ ((uint64_t)idcode << 48);
+
+    m_paths[path].nb_frames++;
+    if (m_report_period.count() > 0 && std::chrono::steady_clock::now() - m_last_report >= m_report_period)
+        m_report();
+
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        Entry &entry = m_window[it->second];
+        if (entry.idcode == idcode && entry.soc == soc && entry.fracsec == fracsec)
+        {
+            if (!(entry.paths_mask & (1u << path)) && arrival_ns > entry.first_arrival_ns)
+            {
+                PathStats &first = m_paths[entry.first_path];
+                uint64_t lead_ns = arrival_ns - entry.first_arrival_ns;
+                first.nb_leads++;
+                first.lead_sum_ns += lead_ns;
+                first.lead_max_ns = std::max(first.lead_max_ns, lead_ns);
+            }
+            entry.paths_mask |= 1u << path;
+            return false;
+        }
+    }
+
+    // a copy arriving after its first copy left the window shall not be processed twice. A frame behind the threshold
+    // by more than the span of the window rather means that the time of the IDCODE moved backwards: the threshold is
+    // reset instead of dropping all the frames until the time catches up
+    uint64_t time = m_frame_time(soc, fracsec);
+    Timeline &timeline = m_timelines[idcode];
+    if (time <= timeline.evicted_time)
+    {
+        if (timeline.evicted_time - time <= timeline.last_time - timeline.evicted_time)
+        {
+            m_nb_late++;
+            return false;
+        }
+        m_nb_resets++;
+        timeline.evicted_time = 0;
+    }
+    timeline.last_time = time;
+
+    size_t slot = m_next_slot;
+    if (m_nb_entries == m_window.size())
+        m_evict(slot);
+    else
+        m_nb_entries++;
+    m_window[slot] = {idcode, soc, fracsec, arrival_ns, path, 1u << path};
+    m_index[key] = slot;
+    m_next_slot = (m_next_slot + 1) % m_window.size();
+    m_paths[path].nb_first++;
+    return true;
+}
+
+void FC37118Redundancy::set_time_base(uint32_t time_base)
+{
+    if (time_base == 0 || time_base == m_time_base)
+        return;
+    m_time_base = time_base;
+    m_timelines.clear();
+}
+
+void FC37118Redundancy::m_evict(size_t slot)
+{
+    Entry &entry = m_window[slot];
+    if (entry.paths_mask == (1u << entry.first_path))
+        m_paths[entry.first_path].nb_only++;
+    // an entry newer than the last frame accepted does not raise the threshold: frame with a wrong (future) time,
+    // or received before the time moved backwards
+    Timeline &timeline = m_timelines[entry.idcode];
+    uint64_t time = m_frame_time(entry.soc, entry.fracsec);
+    if (time <= timeline.last_time)
+        timeline.evicted_time = std::max(timeline.evicted_time, time);
+
+    uint64_t key = frame_time_key(entry.soc, entry.fracsec) ^ ((uint64_t)entry.idcode << 48);
+    auto it = m_index.find(key);
+    if (it != m_index.end() && it->second == slot)
+        m_index.erase(it);
+}
+
+void FC37118Redundancy::m_report()
+{
+    for (auto &stats : m_paths)
+    {
+        Logger::getLogger()->info("Redundancy path %s: %lu frames, first for %lu, received only on this path %lu, mean lead %.3f ms, max lead %.3f ms",
+                                  stats.name.c_str(), stats.nb_frames, stats.nb_first, stats.nb_only,
+                                  stats.nb_leads > 0 ? stats.lead_sum_ns / stats.nb_leads / 1e6 : 0.0, stats.lead_max_ns / 1e6);
+        stats = {stats.name, 0, 0, 0, 0, 0.0, 0};
+    }
+    if (m_nb_late > 0)
+        Logger::getLogger()->info("Redundancy: %lu frames received after the deduplication window dropped", m_nb_late);
+    if (m_nb_resets > 0)
+        Logger::getLogger()->warn("Redundancy: the frame time moved backwards %lu times, deduplication restarted", m_nb_resets);
+    m_nb_late = 0;
+    m_nb_resets = 0;
+    m_last_report = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,404 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include "fc37118.h"
+#include "fc37118server.h"
+
+#define SERVER_FRAME_VERSION 1
+#define SERVER_CMD_FRAME_SIZE 18
+
+static void put_u16(unsigned char *p, unsigned int value)
+{
+    p[0] = (value >> 8) & 0xFF;
+    p[1] = value & 0xFF;
+}
+
+static void put_u32(unsigned char *p, unsigned long value)
+{
+    put_u16(p, (value >> 16) & 0xFFFF);
+    put_u16(p + 2, value & 0xFFFF);
+}
+
+/**
+ * @brief set the frame type in the SYNC word and recompute CHK
+ */
+static void seal_frame(std::vector<unsigned char> &frame, int type)
+{
+    frame[1] = (frame[1] & 0x8F) | (type << 4);
+    put_u16(frame.data() + frame.size() - 2, crc_ccitt(frame.data(), frame.size() - 2));
+}
+
+FC37118Server::FC37118Server() : m_conf(nullptr),
+                                 m_listen_fd(-1),
+                                 m_wake_fd(-1),
+                                 m_thread(nullptr),
+                                 m_is_running(false),
+                                 m_header(SERVER_DEFAULT_HEADER)
+{
+}
+
+FC37118Server::~FC37118Server()
+{
+    stop();
+}
+
+void FC37118Server::configure(FC37118ServerConf *conf)
+{
+    stop();
+    m_conf = conf;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_header = SERVER_DEFAULT_HEADER;
+    m_config_frame.clear();
+}
+
+bool FC37118Server::start()
+{
+    if (!is_enabled() || is_running())
+        return false;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(m_conf->get_ip_addr().c_str());
+    addr.sin_port = htons(m_conf->get_port());
+    std::string name = m_conf->get_ip_addr() + ":" + std::to_string(m_conf->get_port());
+
+    int one = 1;
+    m_listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listen_fd < 0 ||
+        setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(m_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(m_listen_fd, SOMAXCONN) != 0)
+    {
+        Logger::getLogger()->error(SERVER ": unable to listen on " + name + ": " + strerror(errno));
+        stop();
+        return false;
+    }
+    m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake_fd < 0)
+    {
+        Logger::getLogger()->error(SERVER ": unable to create the wake up event: %s", strerror(errno));
+        stop();
+        return false;
+    }
+    m_is_running = true;
+    m_thread = new std::thread(&FC37118Server::m_run, this);
+    Logger::getLogger()->info(SERVER ": listening on " + name);
+    return true;
+}
+
+void FC37118Server::stop()
+{
+    m_is_running = false;
+    if (m_thread != nullptr)
+    {
+        m_wake();
+        m_thread->join();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (!m_clients.empty())
+        m_close(m_clients.back());
+    if (m_listen_fd >= 0)
+        close(m_listen_fd);
+    if (m_wake_fd >= 0)
+        close(m_wake_fd);
+    m_listen_fd = -1;
+    m_wake_fd = -1;
+}
+
+void FC37118Server::set_header(const std::string &header)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_header = header;
+}
+
+void FC37118Server::set_config_frame(const unsigned char *frame, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config_frame.assign(frame, frame + size);
+}
+
+void FC37118Server::forward(const unsigned char *frame, size_t size)
+{
+    std::shared_ptr<std::vector<unsigned char>> copy;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto client : m_clients)
+    {
+        if (client->is_sending)
+            m_send(client, frame, size, copy, true);
+    }
+}
+
+void FC37118Server::m_wake()
+{
+    uint64_t one = 1;
+    if (m_wake_fd >= 0 && write(m_wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        Logger::getLogger()->warn(SERVER ": unable to wake up the server thread: %s", strerror(errno));
+}
+
+/**
+ * @brief send without blocking, queue what the client cannot take at once (copied once for all the clients in copy).
+ * m_mutex shall be held
+ */
+void FC37118Server::m_send(Client *client, const unsigned char *data, size_t size, std::shared_ptr<std::vector<unsigned char>> &copy, bool can_drop)
+{
+    if (client->is_broken)
+        return;
+
+    size_t sent = 0;
+    if (client->queue.empty())
+    {
+        ssize_t n = send(client->fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n == (ssize_t)size)
+        {
+            client->nb_sent++;
+            return;
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            client->is_broken = true;
+            m_wake();
+            return;
+        }
+        sent = n < 0 ? 0 : n;
+    }
+    else if (can_drop && client->queue.size() >= m_conf->get_queue_frames())
+    {
+        if (!client->is_dropping)
+            Logger::getLogger()->warn(SERVER ": client " + client->name + " too slow, dropping its frames");
+        client->is_dropping = true;
+        client->nb_dropped++;
+        return;
+    }
+
+    if (!copy)
+        copy = std::make_shared<std::vector<unsigned char>>(data, data + size);
+    bool was_empty = client->queue.empty();
+    client->queue.push_back({copy, sent});
+    if (was_empty)
+        m_wake();
+}
+
+/**
+ * @brief send the queued frames, m_mutex shall be held
+ */
+void FC37118Server::m_flush(Client *client)
+{
+    while (!client->queue.empty() && !client->is_broken)
+    {
+        auto &pending = client->queue.front();
+        ssize_t n = send(client->fd, pending.frame->data() + pending.offset, pending.frame->size() - pending.offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                client->is_broken = true;
+            return;
+        }
+        pending.offset += n;
+        if (pending.offset < pending.frame->size())
+            return;
+        client->queue.pop_front();
+        client->nb_sent++;
+    }
+    if (client->queue.empty() && client->is_dropping)
+    {
+        client->is_dropping = false;
+        Logger::getLogger()->info(SERVER ": client " + client->name + " caught up, %lu frames dropped so far", client->nb_dropped);
+    }
+}
+
+/**
+ * @brief disconnect a client, m_mutex shall be held
+ */
+void FC37118Server::m_close(Client *client)
+{
+    Logger::getLogger()->info(SERVER ": client " + client->name + " disconnected, %lu frames sent, %lu dropped", client->nb_sent, client->nb_dropped);
+    close(client->fd);
+    m_clients.erase(std::find(m_clients.begin(), m_clients.end(), client));
+    delete client;
+}
+
+void FC37118Server::m_accept()
+{
+    struct sockaddr_in addr;
+    socklen_t addr_size = sizeof(addr);
+    int fd = accept4(m_listen_fd, (struct sockaddr *)&addr, &addr_size, SOCK_CLOEXEC);
+    if (fd < 0)
+        return;
+    std::string name = std::string(inet_ntoa(addr.sin_addr)) + ":" + std::to_string(ntohs(addr.sin_port));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_clients.size() >= m_conf->get_max_clients())
+    {
+        Logger::getLogger()->warn(SERVER ": " SRV_MAX_CLIENTS " reached, client " + name + " rejected");
+        close(fd);
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    auto client = new Client;
+    client->fd = fd;
+    client->name = name;
+    client->is_sending = false;
+    client->is_broken = false;
+    client->is_dropping = false;
+    client->nb_sent = 0;
+    client->nb_dropped = 0;
+    m_clients.push_back(client);
+    Logger::getLogger()->info(SERVER ": client " + name + " connected");
+}
+
+std::vector<unsigned char> FC37118Server::m_header_frame()
+{
+    std::vector<unsigned char> frame(C37118_MIN_FRAME_SIZE + m_header.size());
+    frame[0] = C37118_SYNC_BYTE;
+    frame[1] = SERVER_FRAME_VERSION;
+    put_u16(frame.data() + 2, frame.size());
+    if (m_config_frame.size() >= 6)
+        std::copy(m_config_frame.begin() + 4, m_config_frame.begin() + 6, frame.begin() + 4);
+    put_u32(frame.data() + 6, (unsigned long)time(NULL));
+    std::copy(m_header.begin(), m_header.end(), frame.begin() + 14);
+    seal_frame(frame, C37118_FRAME_TYPE_HEADER);
+    return frame;
+}
+
+/**
+ * @brief answer a command frame of a client, m_mutex shall be held
+ */
+void FC37118Server::m_command(Client *client, const unsigned char *frame)
+{
+    std::shared_ptr<std::vector<unsigned char>> answer;
+    unsigned int cmd = (frame[14] << 8) | frame[15];
+    switch (cmd)
+    {
+    case C37118_CMD_TURNOFF_TX:
+        client->is_sending = false;
+        break;
+    case C37118_CMD_TURNON_TX:
+        client->is_sending = true;
+        break;
+    case C37118_CMD_SEND_HDR:
+        answer = std::make_shared<std::vector<unsigned char>>(m_header_frame());
+        break;
+    case C37118_CMD_SEND_CONFIGURATION_1:
+    case C37118_CMD_SEND_CONFIGURATION_2:
+        if (m_config_frame.empty())
+        {
+            Logger::getLogger()->warn(SERVER ": no c37.118 configuration yet for client " + client->name);
+            break;
+        }
+        answer = std::make_shared<std::vector<unsigned char>>(m_config_frame);
+        seal_frame(*answer, cmd == C37118_CMD_SEND_CONFIGURATION_1 ? C37118_FRAME_TYPE_CONFIGURATION_1 : C37118_FRAME_TYPE_CONFIGURATION_2);
+        break;
+    default:
+        Logger::getLogger()->debug(SERVER ": unsupported command %u from client " + client->name, cmd);
+        break;
+    }
+    if (answer)
+        m_send(client, answer->data(), answer->size(), answer, false);
+}
+
+/**
+ * @return false - the client disconnected
+ */
+bool FC37118Server::m_receive(Client *client)
+{
+    ssize_t n = recv(client->fd, client->reader.write_ptr(), client->reader.write_space(), MSG_DONTWAIT);
+    if (n < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    if (n == 0)
+        return false;
+    client->reader.commit(n);
+
+    unsigned char *frame;
+    size_t size;
+    while (client->reader.next(&frame, &size))
+    {
+        if (frame_type(frame) != C37118_FRAME_TYPE_COMMAND || size < SERVER_CMD_FRAME_SIZE)
+            continue;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_command(client, frame);
+    }
+    return true;
+}
+
+void FC37118Server::m_run()
+{
+    std::vector<struct pollfd> fds;
+    std::vector<Client *> polled;
+    while (m_is_running)
+    {
+        fds.assign(2, pollfd());
+        fds[0] = {m_wake_fd, POLLIN, 0};
+        fds[1] = {m_listen_fd, POLLIN, 0};
+        polled.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < m_clients.size();)
+            {
+                if (m_clients[i]->is_broken)
+                {
+                    m_close(m_clients[i]);
+                    continue;
+                }
+                short events = POLLIN | (m_clients[i]->queue.empty() ? 0 : POLLOUT);
+                fds.push_back({m_clients[i]->fd, events, 0});
+                polled.push_back(m_clients[i]);
+                i++;
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Logger::getLogger()->error(SERVER ": poll failed: %s", strerror(errno));
+            break;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            uint64_t count;
+            if (read(m_wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+                Logger::getLogger()->warn(SERVER ": unable to read the wake up event: %s", strerror(errno));
+        }
+        if (fds[1].revents & POLLIN)
+            m_accept();
+
+        for (size_t i = 0; i < polled.size(); i++)
+        {
+            auto client = polled[i];
+            short revents = fds[i + 2].revents;
+            bool is_connected = true;
+            if (revents & (POLLIN | POLLHUP | POLLERR))
+                is_connected = m_receive(client);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (is_connected && (revents & POLLOUT))
+                m_flush(client);
+            if (!is_connected)
+                client->is_broken = true;
+        }
+    }
+}
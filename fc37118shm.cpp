@@ -0,0 +1,231 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <complex>
+#include <new>
+#include <algorithm>
+
+#include "fc37118shm.h"
+#include "fc37118channel.h"
+
+static inline size_t align_up(size_t size)
+{
+    return (size + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN;
+}
+
+FC37118ShmPublisher::FC37118ShmPublisher() : m_conf(nullptr),
+                                             m_fd(-1),
+                                             m_map(nullptr),
+                                             m_map_size(0),
+                                             m_header(nullptr),
+                                             m_channels(nullptr),
+                                             m_slots(nullptr),
+                                             m_config_version(0),
+                                             m_nb_channels(0),
+                                             m_fits(false)
+{
+}
+
+FC37118ShmPublisher::~FC37118ShmPublisher()
+{
+    close();
+}
+
+void FC37118ShmPublisher::configure(FC37118ShmConf *conf)
+{
+    close();
+    m_conf = conf;
+}
+
+bool FC37118ShmPublisher::open()
+{
+    close();
+    if (!is_enabled())
+        return false;
+
+    size_t channels_offset = align_up(sizeof(FC37118ShmHeader));
+    size_t slots_offset = channels_offset + align_up(m_conf->get_max_channels() * sizeof(FC37118ShmChannel));
+    size_t slot_size = align_up(sizeof(FC37118ShmSlotHeader) + m_conf->get_max_channels() * sizeof(float));
+    m_map_size = slots_offset + slot_size * m_conf->get_slots();
+
+    // a new segment, so that readers still mapping a previous one see it closed
+    shm_unlink(m_conf->get_name().c_str());
+    m_fd = shm_open(m_conf->get_name().c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (m_fd < 0 || ftruncate(m_fd, m_map_size) != 0)
+    {
+        Logger::getLogger()->error(SHM ": unable to create " + m_conf->get_name() + ": " + strerror(errno));
+        close();
+        return false;
+    }
+    m_map = mmap(nullptr, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_map == MAP_FAILED)
+    {
+        m_map = nullptr;
+        Logger::getLogger()->error(SHM ": unable to map " + m_conf->get_name() + ": " + strerror(errno));
+        close();
+        return false;
+    }
+
+    // the segment is zero filled by ftruncate
+    m_header = new (m_map) FC37118ShmHeader();
+    m_header->layout_version = SHM_LAYOUT_VERSION;
+    m_header->writer_pid = getpid();
+    m_header->slot_count = m_conf->get_slots();
+    m_header->slot_size = slot_size;
+    m_header->max_channels = m_conf->get_max_channels();
+    m_header->channels_offset = channels_offset;
+    m_header->slots_offset = slots_offset;
+    m_header->is_closed.store(0, std::memory_order_relaxed);
+    m_header->write_count.store(0, std::memory_order_relaxed);
+    m_header->channels_seq.store(0, std::memory_order_relaxed);
+    m_channels = (FC37118ShmChannel *)((unsigned char *)m_map + channels_offset);
+    m_slots = (unsigned char *)m_map + slots_offset;
+    for (uint32_t i = 0; i < m_header->slot_count; i++)
+        new (m_slots + (size_t)i * slot_size) FC37118ShmSlotHeader();
+    m_config_version = 0;
+
+    // the magic is written last: a reader never sees a partially initialised header
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, SHM_MAGIC, sizeof(m_header->magic));
+    Logger::getLogger()->info(SHM ": publishing decoded frames in " + m_conf->get_name());
+    return true;
+}
+
+void FC37118ShmPublisher::close()
+{
+    if (m_header != nullptr)
+        m_header->is_closed.store(1, std::memory_order_release);
+    if (m_map != nullptr)
+        munmap(m_map, m_map_size);
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        shm_unlink(m_conf->get_name().c_str());
+    }
+    m_fd = -1;
+    m_map = nullptr;
+    m_header = nullptr;
+    m_channels = nullptr;
+    m_slots = nullptr;
+}
+
+static void copy_name(char *target, const std::string &name)
+{
+    memset(target, 0, SHM_NAME_SIZE);
+    memcpy(target, name.c_str(), std::min(name.size(), (size_t)SHM_NAME_SIZE));
+}
+
+void FC37118ShmPublisher::m_describe(CONFIG_Frame *config_frame, unsigned long config_version, const std::vector<uint> &filter)
+{
+    m_config_version = config_version;
+    m_stations.clear();
+    m_nb_channels = 0;
+
+    std::vector<FC37118ShmChannel> channels;
+    size_t station_index = 0;
+    for (auto pmu_station : config_frame->pmu_station_list)
+    {
+        if (filter.empty() || std::find(filter.begin(), filter.end(), pmu_station->IDCODE_get()) != filter.end())
+        {
+            m_stations.push_back(station_index);
+            FC37118ShmChannel channel;
+            memset(&channel, 0, sizeof(channel));
+            channel.idcode = pmu_station->IDCODE_get();
+            channel.station_index = station_index;
+            copy_name(channel.station_name, pmu_station->STN_get());
+
+            auto add = [&](uint8_t kind, const std::string &name)
+            {
+                channel.kind = kind;
+                copy_name(channel.name, name);
+                channels.push_back(channel);
+            };
+            add(SHM_CHANNEL_STAT, "STAT");
+            add(SHM_CHANNEL_FREQ, CHANNEL_FREQ);
+            add(SHM_CHANNEL_DFREQ, CHANNEL_DFREQ);
+            for (int i = 0; i < pmu_station->PHNMR_get(); i++)
+            {
+                add(SHM_CHANNEL_PHASOR_MAGNITUDE, pmu_station->PH_NAME_get(i));
+                add(SHM_CHANNEL_PHASOR_ANGLE, pmu_station->PH_NAME_get(i));
+            }
+            for (int i = 0; i < pmu_station->ANNMR_get(); i++)
+                add(SHM_CHANNEL_ANALOG, pmu_station->AN_NAME_get(i));
+        }
+        station_index++;
+    }
+
+    m_fits = channels.size() <= m_header->max_channels;
+    if (!m_fits)
+    {
+        Logger::getLogger()->error(SHM ": the configuration has %lu channels, more than " SHM_MAX_CHANNELS " (%u), nothing is published",
+                                   (unsigned long)channels.size(), m_header->max_channels);
+        return;
+    }
+    m_nb_channels = channels.size();
+
+    uint64_t seq = m_header->channels_seq.load(std::memory_order_relaxed);
+    m_header->channels_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_channels, channels.data(), channels.size() * sizeof(FC37118ShmChannel));
+    m_header->config_version = config_version;
+    m_header->nb_channels = m_nb_channels;
+    m_header->nb_stations = m_stations.size();
+    m_header->channels_seq.store(seq + 2, std::memory_order_release);
+}
+
+void FC37118ShmPublisher::publish(CONFIG_Frame *config_frame, unsigned long config_version, const std::vector<uint> &filter,
+                                  uint32_t soc, uint32_t fracsec, double frame_time)
+{
+    if (m_header == nullptr)
+        return;
+    if (config_version != m_config_version)
+        m_describe(config_frame, config_version, filter);
+    if (!m_fits)
+        return;
+
+    uint64_t count = m_header->write_count.load(std::memory_order_relaxed);
+    auto slot = (FC37118ShmSlotHeader *)(m_slots + (count % m_header->slot_count) * m_header->slot_size);
+    float *values = (float *)(slot + 1);
+
+    uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->frame_count = count + 1;
+    slot->config_version = config_version;
+    slot->soc = soc;
+    slot->fracsec = fracsec;
+    slot->frame_time = frame_time;
+    slot->nb_channels = m_nb_channels;
+    for (auto station_index : m_stations)
+    {
+        PMU_Station *pmu_station = config_frame->pmu_station_list[station_index];
+        *values++ = pmu_station->STAT_get();
+        *values++ = station_frequency(pmu_station);
+        *values++ = station_rocof(pmu_station);
+        for (int i = 0; i < pmu_station->PHNMR_get(); i++)
+        {
+            std::complex<float> phasor = pmu_station->PHASOR_VALUE_get(i);
+            *values++ = std::abs(phasor);
+            *values++ = std::arg(phasor);
+        }
+        for (int i = 0; i < pmu_station->ANNMR_get(); i++)
+            *values++ = pmu_station->ANALOG_VALUE_get(i);
+    }
+
+    slot->seq.store(seq + 2, std::memory_order_release);
+    m_header->write_count.store(count + 1, std::memory_order_release);
+}
@@ -0,0 +1,94 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "fc37118soak.h"
+
+long get_rss_kb()
+{
+    long size, resident;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+        return -1;
+    int n = fscanf(statm, "%ld %ld", &size, &resident);
+    fclose(statm);
+    if (n != 2)
+        return -1;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+FC37118Soak::FC37118Soak() : m_conf(nullptr),
+                             m_nb_frames(0),
+                             m_baseline_rss_kb(-1),
+                             m_max_growth_kb(0),
+                             m_is_failed(false)
+{
+}
+
+FC37118Soak::~FC37118Soak() {}
+
+void FC37118Soak::configure(FC37118SoakConf *conf)
+{
+    m_conf = conf;
+}
+
+void FC37118Soak::start()
+{
+    m_start = std::chrono::steady_clock::now();
+    m_next_sample = m_start + std::chrono::seconds(m_conf->get_sample_period_s());
+    m_nb_frames = 0;
+    m_baseline_rss_kb = -1;
+    m_max_growth_kb = 0;
+    m_is_failed = false;
+    Logger::getLogger()->info("Soak: started, RSS %ld kB", get_rss_kb());
+}
+
+void FC37118Soak::m_sample()
+{
+    auto now = std::chrono::steady_clock::now();
+    m_next_sample = now + std::chrono::seconds(m_conf->get_sample_period_s());
+
+    long rss_kb = get_rss_kb();
+    Logger::getLogger()->info("Soak: %lu frames, RSS %ld kB", (unsigned long)m_nb_frames, rss_kb);
+
+    if (m_baseline_rss_kb < 0)
+    {
+        if (now - m_start >= std::chrono::seconds(m_conf->get_warmup_s()))
+        {
+            m_baseline_rss_kb = rss_kb;
+            Logger::getLogger()->info("Soak: warmup over, baseline RSS %ld kB", rss_kb);
+        }
+        return;
+    }
+
+    long growth_kb = rss_kb - m_baseline_rss_kb;
+    m_max_growth_kb = std::max(m_max_growth_kb, growth_kb);
+    if (growth_kb > (long)m_conf->get_max_growth_kb() && !m_is_failed)
+    {
+        m_is_failed = true;
+        Logger::getLogger()->error("Soak: RSS grew by %ld kB since the warmup, more than " SOAK_MAX_GROWTH_KB " (%u kB)",
+                                   growth_kb, m_conf->get_max_growth_kb());
+    }
+}
+
+void FC37118Soak::stop()
+{
+    m_sample();
+    if (m_baseline_rss_kb < 0)
+        Logger::getLogger()->warn("Soak: stopped before the end of the warmup after %lu frames, no verdict", (unsigned long)m_nb_frames);
+    else if (m_is_failed)
+        Logger::getLogger()->error("Soak: FAILED after %lu frames, max RSS growth %ld kB", (unsigned long)m_nb_frames, m_max_growth_kb);
+    else
+        Logger::getLogger()->info("Soak: PASSED after %lu frames, max RSS growth %ld kB", (unsigned long)m_nb_frames, m_max_growth_kb);
+}
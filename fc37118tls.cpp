@@ -0,0 +1,229 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <algorithm>
+
+#include "fc37118tls.h"
+
+#ifdef HAVE_OPENSSL
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509.h>
+#include <openssl/x509_vfy.h>
+#include <openssl/evp.h>
+
+static void log_ssl_errors(const std::string &context)
+{
+    unsigned long error;
+    char message[256];
+    bool logged = false;
+    while ((error = ERR_get_error()) != 0)
+    {
+        ERR_error_string_n(error, message, sizeof(message));
+        Logger::getLogger()->error(context + ": " + message);
+        logged = true;
+    }
+    if (!logged)
+        Logger::getLogger()->error(context);
+}
+#endif
+
+FC37118Tls::FC37118Tls() : m_conf(nullptr),
+                           m_ctx(nullptr),
+                           m_ssl(nullptr),
+                           m_kernel_rx(false)
+{
+}
+
+FC37118Tls::~FC37118Tls()
+{
+    configure(nullptr);
+}
+
+void FC37118Tls::configure(FC37118TlsConf *conf)
+{
+    close();
+#ifdef HAVE_OPENSSL
+    SSL_CTX_free(m_ctx);
+#endif
+    m_ctx = nullptr;
+    m_conf = conf;
+}
+
+#ifdef HAVE_OPENSSL
+
+bool FC37118Tls::m_init_context()
+{
+    m_ctx = SSL_CTX_new(TLS_client_method());
+    if (m_ctx == nullptr)
+    {
+        log_ssl_errors("TLS context creation failed");
+        return false;
+    }
+    SSL_CTX_set_min_proto_version(m_ctx, TLS1_2_VERSION);
+
+    bool is_ok = true;
+    if (!m_conf->get_ca_file().empty())
+    {
+        is_ok &= SSL_CTX_load_verify_locations(m_ctx, m_conf->get_ca_file().c_str(), nullptr) == 1;
+        SSL_CTX_set_verify(m_ctx, SSL_VERIFY_PEER, nullptr);
+    }
+    else
+    {
+        // authentication by the pinned fingerprints only, checked after the handshake
+        SSL_CTX_set_verify(m_ctx, SSL_VERIFY_NONE, nullptr);
+    }
+    if (is_ok && !m_conf->get_cert_file().empty())
+    {
+        is_ok &= SSL_CTX_use_certificate_chain_file(m_ctx, m_conf->get_cert_file().c_str()) == 1 &&
+                 SSL_CTX_use_PrivateKey_file(m_ctx, m_conf->get_key_file().c_str(), SSL_FILETYPE_PEM) == 1 &&
+                 SSL_CTX_check_private_key(m_ctx) == 1;
+    }
+    if (m_conf->is_ktls())
+        SSL_CTX_set_options(m_ctx, SSL_OP_ENABLE_KTLS);
+
+    if (!is_ok)
+    {
+        log_ssl_errors("Unable to load the TLS certificates");
+        SSL_CTX_free(m_ctx);
+        m_ctx = nullptr;
+    }
+    return is_ok;
+}
+
+bool FC37118Tls::m_check_pinning()
+{
+    auto pinned = m_conf->get_pinned_sha256();
+    if (pinned.empty())
+        return true;
+
+    X509 *cert = SSL_get1_peer_certificate(m_ssl);
+    if (cert == nullptr)
+    {
+        Logger::getLogger()->error("TLS: the PMU sent no certificate");
+        return false;
+    }
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int md_size = 0;
+    bool is_digest = X509_digest(cert, EVP_sha256(), md, &md_size) == 1;
+    X509_free(cert);
+    if (!is_digest)
+    {
+        log_ssl_errors("TLS: unable to compute the PMU certificate fingerprint");
+        return false;
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    std::string fingerprint;
+    for (unsigned int i = 0; i < md_size; i++)
+    {
+        fingerprint += hex[md[i] >> 4];
+        fingerprint += hex[md[i] & 0x0F];
+    }
+    if (std::find(pinned.begin(), pinned.end(), fingerprint) != pinned.end())
+        return true;
+    Logger::getLogger()->error("TLS: the PMU certificate fingerprint " + fingerprint + " is not pinned");
+    return false;
+}
+
+bool FC37118Tls::handshake(int sockfd, const std::string &peer_address)
+{
+    close();
+    if (m_ctx == nullptr && !m_init_context())
+        return false;
+
+    m_ssl = SSL_new(m_ctx);
+    if (m_ssl == nullptr || SSL_set_fd(m_ssl, sockfd) != 1)
+    {
+        log_ssl_errors("TLS session creation failed");
+        close();
+        return false;
+    }
+    // the certificate shall be issued to this PMU, not only by the CA: SERVER_NAME, or else the address connected to
+    std::string server_name = m_conf->get_server_name();
+    bool is_identity_set = true;
+    if (!server_name.empty())
+        is_identity_set = SSL_set_tlsext_host_name(m_ssl, server_name.c_str()) == 1 &&
+                          SSL_set1_host(m_ssl, server_name.c_str()) == 1;
+    else if (!m_conf->get_ca_file().empty())
+        is_identity_set = X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(m_ssl), peer_address.c_str()) == 1;
+    if (!is_identity_set)
+    {
+        log_ssl_errors("TLS: unable to set the expected PMU identity");
+        close();
+        return false;
+    }
+
+    if (SSL_connect(m_ssl) != 1)
+    {
+        log_ssl_errors("TLS handshake with the PMU failed");
+        close();
+        return false;
+    }
+    if (!m_check_pinning())
+    {
+        close();
+        return false;
+    }
+
+    m_kernel_rx = BIO_get_ktls_recv(SSL_get_rbio(m_ssl)) > 0;
+    bool kernel_tx = BIO_get_ktls_send(SSL_get_wbio(m_ssl)) > 0;
+    Logger::getLogger()->info("TLS session established: %s, %s, kernel TLS receive %s, send %s",
+                              SSL_get_version(m_ssl), SSL_get_cipher_name(m_ssl),
+                              m_kernel_rx ? "on" : "off", kernel_tx ? "on" : "off");
+    if (m_conf->is_ktls() && !m_kernel_rx)
+        Logger::getLogger()->warn("TLS: kernel TLS not available for this session (tls kernel module, cipher or OpenSSL build), records are decrypted in user space");
+    return true;
+}
+
+int FC37118Tls::read(unsigned char *buffer, size_t size)
+{
+    int n = SSL_read(m_ssl, buffer, size);
+    if (n > 0)
+        return n;
+    int error = SSL_get_error(m_ssl, n);
+    if (error == SSL_ERROR_ZERO_RETURN)
+        return 0;
+    if (error == SSL_ERROR_SSL)
+        log_ssl_errors("TLS read failed");
+    return -1;
+}
+
+int FC37118Tls::write(const unsigned char *buffer, size_t size)
+{
+    int n = SSL_write(m_ssl, buffer, size);
+    if (n <= 0 && SSL_get_error(m_ssl, n) == SSL_ERROR_SSL)
+        log_ssl_errors("TLS write failed");
+    return n;
+}
+
+void FC37118Tls::close()
+{
+    SSL_free(m_ssl);
+    m_ssl = nullptr;
+    m_kernel_rx = false;
+}
+
+#else
+
+bool FC37118Tls::m_init_context() { return false; }
+bool FC37118Tls::m_check_pinning() { return false; }
+
+bool FC37118Tls::handshake(int sockfd, const std::string &peer_address)
+{
+    Logger::getLogger()->error(TLS " is configured but the plugin is built without OpenSSL");
+    return false;
+}
+
+int FC37118Tls::read(unsigned char *buffer, size_t size) { return -1; }
+int FC37118Tls::write(const unsigned char *buffer, size_t size) { return -1; }
+void FC37118Tls::close() { m_kernel_rx = false; }
+
+#endif
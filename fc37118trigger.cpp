@@ -0,0 +1,238 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <cmath>
+#include <climits>
+
+#include "fc37118trigger.h"
+#include "fc37118channel.h"
+#include "fc37118datapoint.h"
+
+FC37118Trigger::FC37118Trigger() : m_conf(nullptr),
+                                   m_config_version(0),
+                                   m_stream_idcode(0),
+                                   m_previous_time(0)
+{
+}
+
+FC37118Trigger::~FC37118Trigger()
+{
+    clear();
+}
+
+void FC37118Trigger::configure(FC37118TriggerConf *conf)
+{
+    clear();
+    m_conf = conf;
+    m_config_version = 0;
+}
+
+/**
+ * @brief delete the readings held in the pre-trigger buffers
+ */
+void FC37118Trigger::clear()
+{
+    for (auto &output : m_outputs)
+    {
+        for (size_t i = 0; i < output.second.count; i++)
+            delete output.second.ring[(output.second.head + i) % output.second.ring.size()].reading.reading;
+    }
+    m_outputs.clear();
+    m_fired_rules.clear();
+}
+
+void FC37118Trigger::flush(std::vector<FC37118Reading> &output)
+{
+    for (auto &state : m_outputs)
+        m_flush(state.second, output, false);
+    m_outputs.clear();
+    m_fired_rules.clear();
+}
+
+void FC37118Trigger::m_setup(CONFIG_Frame *config_frame)
+{
+    clear();
+    m_stations.clear();
+    m_stream_idcode = config_frame->IDCODE_get();
+    for (auto pmu_station : config_frame->pmu_station_list)
+    {
+        StationState state;
+        state.idcode = pmu_station->IDCODE_get();
+        state.has_previous = false;
+        for (auto &name : m_conf->get_voltage_channels())
+        {
+            for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+            {
+                if (pmu_station->PH_NAME_get(k) == name)
+                    state.voltage_channels.push_back(k);
+            }
+        }
+        state.baselines.assign(state.voltage_channels.size(), 0);
+        state.previous_angles.assign(state.voltage_channels.size(), 0);
+        m_stations.push_back(state);
+    }
+}
+
+/**
+ * @brief evaluate the rules of a station
+ *
+ * @return std::string - the fired rules separated by spaces, empty if none fired
+ */
+std::string FC37118Trigger::m_evaluate_station(PMU_Station *pmu_station, StationState &state, double dt)
+{
+    std::string rules;
+    double fnom = station_fnom(pmu_station);
+    double frequency = station_frequency(pmu_station);
+
+    if (pmu_station->STAT_get() & m_conf->get_stat_mask())
+        rules += " " TRG_RULE_STAT;
+    if (m_conf->get_freq_deviation() > 0 && std::abs(frequency - fnom) > m_conf->get_freq_deviation())
+        rules += " " TRG_FREQ_DEVIATION;
+    if (m_conf->get_rocof() > 0 && std::abs(station_rocof(pmu_station)) > m_conf->get_rocof())
+        rules += " " TRG_ROCOF;
+
+    bool is_sag = false, is_jump = false;
+    double alpha = std::min(1.0, dt / TRG_BASELINE_TAU_S);
+    for (size_t v = 0; v < state.voltage_channels.size(); v++)
+    {
+        auto phasor = pmu_station->PHASOR_VALUE_get(state.voltage_channels[v]);
+        double magnitude = std::abs(phasor), angle = std::arg(phasor);
+
+        if (m_conf->get_voltage_sag() > 0)
+        {
+            if (!state.has_previous)
+                state.baselines[v] = magnitude;
+            else if (magnitude < m_conf->get_voltage_sag() * state.baselines[v])
+                is_sag = true;
+            else
+                state.baselines[v] += alpha * (magnitude - state.baselines[v]);
+        }
+
+        // angle step once the rotation due to the frequency deviation is removed
+        if (m_conf->get_angle_jump() > 0 && state.has_previous && dt > 0)
+        {
+            double jump = angle - state.previous_angles[v] - 2 * M_PI * (frequency - fnom) * dt;
+            jump -= 2 * M_PI * std::round(jump / (2 * M_PI));
+            is_jump |= std::abs(jump) > m_conf->get_angle_jump();
+        }
+        state.previous_angles[v] = angle;
+    }
+    state.has_previous = true;
+
+    if (is_sag)
+        rules += " " TRG_VOLTAGE_SAG;
+    if (is_jump)
+        rules += " " TRG_ANGLE_JUMP;
+    return rules.empty() ? rules : rules.substr(1);
+}
+
+void FC37118Trigger::evaluate(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time)
+{
+    if (config_version != m_config_version)
+    {
+        m_setup(config_frame);
+        m_config_version = config_version;
+        m_previous_time = frame_time;
+    }
+    double dt = frame_time - m_previous_time;
+    m_previous_time = frame_time;
+
+    m_fired_rules.clear();
+    std::string stream_rules;
+    for (size_t i = 0; i < m_stations.size(); i++)
+    {
+        auto rules = m_evaluate_station(config_frame->pmu_station_list[i], m_stations[i], dt);
+        if (rules.empty())
+            continue;
+        m_fired_rules[m_stations[i].idcode] = rules;
+        stream_rules += (stream_rules.empty() ? "" : " ") + std::to_string(m_stations[i].idcode) + ":" + rules;
+    }
+    if (!stream_rules.empty() && m_fired_rules.find(m_stream_idcode) == m_fired_rules.end())
+        m_fired_rules[m_stream_idcode] = stream_rules;
+}
+
+/**
+ * @brief empty the pre-trigger buffer in time order
+ *
+ * @param is_all output all the readings, or only the OUTPUT_RATE ones and delete the others
+ */
+void FC37118Trigger::m_flush(OutputState &state, std::vector<FC37118Reading> &output, bool is_all)
+{
+    for (size_t i = 0; i < state.count; i++)
+    {
+        auto &held = state.ring[(state.head + i) % state.ring.size()];
+        if (is_all || held.is_output)
+            output.push_back(held.reading);
+        else
+            delete held.reading.reading;
+    }
+    state.head = 0;
+    state.count = 0;
+}
+
+void FC37118Trigger::filter(const FC37118Reading &reading, double frame_time, std::vector<FC37118Reading> &output)
+{
+    auto it = m_outputs.find(reading.idcode);
+    if (it == m_outputs.end())
+    {
+        OutputState state;
+        state.ring.assign(m_conf->get_pre_frames(), HeldReading());
+        state.head = 0;
+        state.count = 0;
+        state.post_remaining = 0;
+        state.last_slot = LONG_MIN;
+        it = m_outputs.insert({reading.idcode, state}).first;
+    }
+    auto &state = it->second;
+
+    auto fired = m_fired_rules.find(reading.idcode);
+    if (fired != m_fired_rules.end())
+    {
+        if (state.post_remaining == 0)
+            Logger::getLogger()->info("Trigger on %u: " + fired->second, reading.idcode);
+        reading.reading->addDatapoint(create_dp(DP_TRIGGER, fired->second));
+        m_flush(state, output, true);
+        output.push_back(reading);
+        state.post_remaining = m_conf->get_post_frames();
+        return;
+    }
+    if (state.post_remaining > 0)
+    {
+        state.post_remaining--;
+        output.push_back(reading);
+        return;
+    }
+
+    long slot = (long)std::floor(frame_time * m_conf->get_output_rate() + 1e-6);
+    bool is_output = slot != state.last_slot;
+    state.last_slot = slot;
+    if (state.ring.empty())
+    {
+        if (is_output)
+            output.push_back(reading);
+        else
+            delete reading.reading;
+        return;
+    }
+    // the OUTPUT_RATE readings wait in the buffer too, so that a flush never outputs readings older than them
+    size_t tail = (state.head + state.count) % state.ring.size();
+    if (state.count == state.ring.size())
+    {
+        auto &oldest = state.ring[state.head];
+        if (oldest.is_output)
+            output.push_back(oldest.reading);
+        else
+            delete oldest.reading.reading;
+        state.head = (state.head + 1) % state.ring.size();
+    }
+    else
+        state.count++;
+    state.ring[tail] = {reading, is_output};
+}
@@ -0,0 +1,289 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "fc37118uring.h"
+
+#define URING_ENTRIES 4
+#define URING_RECV_USER_DATA 1
+#define URING_BUFFER_GROUP 0
+
+#ifndef IORING_SETUP_CQSIZE
+#define IORING_SETUP_CQSIZE (1U << 3)
+#endif
+
+static int uring_setup(unsigned entries, struct io_uring_params *params)
+{
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+static int uring_register(int ring_fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+template <typename T>
+static inline T load_acquire(T *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+static inline void store_release(T *p, T v)
+{
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+FC37118Uring::FC37118Uring() : m_conf(nullptr),
+                               m_ring_fd(-1),
+                               m_sockfd(-1),
+                               m_sq_ring(nullptr),
+                               m_sq_ring_size(0),
+                               m_cq_ring(nullptr),
+                               m_cq_ring_size(0),
+                               m_sqes(nullptr),
+                               m_sqes_size(0),
+                               m_buf_ring(nullptr),
+                               m_buffers(nullptr),
+                               m_buf_tail(0),
+                               m_pending_buffer(-1),
+                               m_is_armed(false),
+                               m_nb_completions(0)
+{
+}
+
+FC37118Uring::~FC37118Uring()
+{
+    close();
+}
+
+void FC37118Uring::configure(FC37118UringConf *conf)
+{
+    close();
+    m_conf = conf;
+}
+
+bool FC37118Uring::open(int sockfd)
+{
+    close();
+    if (!is_enabled())
+        return false;
+    m_sockfd = sockfd;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // one completion per filled buffer may be pending: the completion queue holds at least BUFFERS entries, so that
+    // it does not overflow when all the buffers are filled before the completions are reaped
+    params.flags |= IORING_SETUP_CQSIZE;
+    params.cq_entries = std::max((unsigned)m_conf->get_buffers(), 2u * URING_ENTRIES);
+    m_ring_fd = uring_setup(URING_ENTRIES, &params);
+    if (m_ring_fd < 0)
+    {
+        Logger::getLogger()->warn(IO_URING ": io_uring not available (%s), using read()", strerror(errno));
+        m_ring_fd = -1;
+        return false;
+    }
+
+    m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+    m_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+    if (m_sq_ring == MAP_FAILED)
+        m_sq_ring = nullptr;
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        m_cq_ring = m_sq_ring;
+    else
+    {
+        m_cq_ring = mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING);
+        if (m_cq_ring == MAP_FAILED)
+            m_cq_ring = nullptr;
+    }
+    m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES);
+    m_sqes = sqes == MAP_FAILED ? nullptr : (struct io_uring_sqe *)sqes;
+    if (m_sq_ring == nullptr || m_cq_ring == nullptr || m_sqes == nullptr)
+    {
+        Logger::getLogger()->warn(IO_URING ": unable to map the rings (%s), using read()", strerror(errno));
+        close();
+        return false;
+    }
+    auto sq = (unsigned char *)m_sq_ring;
+    auto cq = (unsigned char *)m_cq_ring;
+    m_sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    m_sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    m_sq_array = (unsigned *)(sq + params.sq_off.array);
+    m_cq_head = (unsigned *)(cq + params.cq_off.head);
+    m_cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    m_cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    m_cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // provided buffer ring, page aligned
+    unsigned nb_buffers = m_conf->get_buffers();
+    void *buf_ring = nullptr;
+    m_buffers = (unsigned char *)malloc((size_t)nb_buffers * m_conf->get_buffer_size());
+    if (posix_memalign(&buf_ring, sysconf(_SC_PAGESIZE), nb_buffers * sizeof(struct io_uring_buf)) != 0 || m_buffers == nullptr)
+    {
+        free(buf_ring);
+        Logger::getLogger()->warn(IO_URING ": unable to allocate the buffers, using read()");
+        close();
+        return false;
+    }
+    m_buf_ring = (struct io_uring_buf_ring *)buf_ring;
+    memset(m_buf_ring, 0, nb_buffers * sizeof(struct io_uring_buf));
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)m_buf_ring;
+    reg.ring_entries = nb_buffers;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (uring_register(m_ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+    {
+        Logger::getLogger()->warn(IO_URING ": provided buffer rings not supported (%s), using read()", strerror(errno));
+        close();
+        return false;
+    }
+    m_buf_tail = 0;
+    for (unsigned i = 0; i < nb_buffers; i++)
+        m_provide(i);
+
+    if (!m_arm())
+    {
+        Logger::getLogger()->warn(IO_URING ": unable to submit the receive (%s), using read()", strerror(errno));
+        close();
+        return false;
+    }
+    Logger::getLogger()->debug(IO_URING ": multishot receive armed with %u buffers of %u bytes", nb_buffers, m_conf->get_buffer_size());
+    return true;
+}
+
+void FC37118Uring::close()
+{
+    if (m_ring_fd >= 0)
+        ::close(m_ring_fd);
+    if (m_sqes != nullptr)
+        munmap(m_sqes, m_sqes_size);
+    if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring)
+        munmap(m_cq_ring, m_cq_ring_size);
+    if (m_sq_ring != nullptr)
+        munmap(m_sq_ring, m_sq_ring_size);
+    free(m_buf_ring);
+    free(m_buffers);
+    m_ring_fd = -1;
+    m_sqes = nullptr;
+    m_sq_ring = nullptr;
+    m_cq_ring = nullptr;
+    m_buf_ring = nullptr;
+    m_buffers = nullptr;
+    m_pending_buffer = -1;
+    m_is_armed = false;
+    m_nb_completions = 0;
+}
+
+void FC37118Uring::m_provide(uint16_t buffer_id)
+{
+    unsigned mask = m_conf->get_buffers() - 1;
+    // the entries start at the ring address: in C++ the empty struct of __DECLARE_FLEX_ARRAY shifts bufs[]
+    struct io_uring_buf *buf = (struct io_uring_buf *)m_buf_ring + (m_buf_tail & mask);
+    buf->addr = (uint64_t)(uintptr_t)(m_buffers + (size_t)buffer_id * m_conf->get_buffer_size());
+    buf->len = m_conf->get_buffer_size();
+    buf->bid = buffer_id;
+    m_buf_tail++;
+    store_release(&m_buf_ring->tail, m_buf_tail);
+}
+
+bool FC37118Uring::m_arm()
+{
+    unsigned tail = *m_sq_tail;
+    unsigned index = tail & *m_sq_mask;
+    struct io_uring_sqe *sqe = &m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = m_sockfd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = URING_RECV_USER_DATA;
+    m_sq_array[index] = index;
+    store_release(m_sq_tail, tail + 1);
+
+    int n;
+    while ((n = uring_enter(m_ring_fd, 1, 0, 0)) < 0 && errno == EINTR)
+        ;
+    m_is_armed = n == 1;
+    return m_is_armed;
+}
+
+int FC37118Uring::receive(unsigned char **data)
+{
+    while (true)
+    {
+        if (!m_is_armed && !m_arm())
+            return -1;
+
+        unsigned head = *m_cq_head;
+        if (head == load_acquire(m_cq_tail))
+        {
+            if (uring_enter(m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                return -1;
+            continue;
+        }
+        struct io_uring_cqe *cqe = &m_cqes[head & *m_cq_mask];
+        int res = cqe->res;
+        unsigned flags = cqe->flags;
+        store_release(m_cq_head, head + 1);
+
+        if (!(flags & IORING_CQE_F_MORE))
+            m_is_armed = false;
+        if (res == -ENOBUFS)
+            continue; // all buffers in use, the receive is armed again once buffers are released
+        if (res == -EINVAL && m_nb_completions == 0)
+        {
+            Logger::getLogger()->warn(IO_URING ": multishot receive not supported by the kernel, using read()");
+            close();
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+        m_nb_completions++;
+        if (res < 0)
+        {
+            errno = -res;
+            return -1;
+        }
+        if (res == 0 || !(flags & IORING_CQE_F_BUFFER))
+            return 0;
+
+        m_pending_buffer = flags >> IORING_CQE_BUFFER_SHIFT;
+        *data = m_buffers + (size_t)m_pending_buffer * m_conf->get_buffer_size();
+        return res;
+    }
+}
+
+void FC37118Uring::release()
+{
+    if (m_pending_buffer < 0)
+        return;
+    m_provide(m_pending_buffer);
+    m_pending_buffer = -1;
+}
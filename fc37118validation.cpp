@@ -0,0 +1,279 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "fc37118validation.h"
+#include "fc37118datapoint.h"
+#include "fc37118channel.h"
+#include "fc37118chunk.h"
+
+// beyond this gap between two frames, the steps are not checked
+#define VALIDATION_MAX_GAP_S 1.0
+
+static const char *bad_reasons[BAD_NB_REASONS] = {"NAN", "RANGE", "FROZEN", "STEP", "STAT"};
+
+std::string FC37118Validation::to_reasons(uint8_t flags)
+{
+    std::string reasons;
+    for (int r = 0; r < BAD_NB_REASONS; r++)
+    {
+        if (flags & (1 << r))
+            reasons += (reasons.empty() ? "" : "|") + std::string(bad_reasons[r]);
+    }
+    return reasons;
+}
+
+FC37118Validation::FC37118Validation() : m_conf(nullptr),
+                                         m_config_version(0),
+                                         m_previous_time(0),
+                                         m_has_previous(false)
+{
+}
+
+FC37118Validation::~FC37118Validation()
+{
+}
+
+void FC37118Validation::configure(FC37118ValidationConf *conf)
+{
+    m_conf = conf;
+    m_config_version = 0;
+    if (is_enabled())
+        m_next_report = std::chrono::steady_clock::now() + std::chrono::seconds(m_conf->get_report_period());
+}
+
+/**
+ * @brief lay out the channels of the configuration, with their bounds
+ */
+void FC37118Validation::m_setup(CONFIG_Frame *config_frame)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    m_offsets.clear();
+    m_idcodes.clear();
+    m_fnoms.clear();
+    m_labels.clear();
+    m_kinds.clear();
+    m_stations.clear();
+    m_mins.clear();
+    m_maxs.clear();
+    auto add = [this](size_t station, const std::string &label, ChannelKind kind, double min, double max)
+    {
+        m_labels.push_back(label);
+        m_kinds.push_back(kind);
+        m_stations.push_back(station);
+        m_mins.push_back(min);
+        m_maxs.push_back(max);
+    };
+
+    double deviation = m_conf->get_freq_deviation() > 0 ? m_conf->get_freq_deviation() : inf;
+    double voltage_max = m_conf->get_voltage_max() > 0 ? m_conf->get_voltage_max() : inf;
+    double current_max = m_conf->get_current_max() > 0 ? m_conf->get_current_max() : inf;
+    for (size_t s = 0; s < config_frame->pmu_station_list.size(); s++)
+    {
+        auto pmu_station = config_frame->pmu_station_list[s];
+        double fnom = station_fnom(pmu_station);
+        m_offsets.push_back(m_labels.size());
+        m_idcodes.push_back(pmu_station->IDCODE_get());
+        m_fnoms.push_back(fnom);
+        add(s, CHANNEL_FREQ, FREQ, fnom - deviation, fnom + deviation);
+        add(s, CHANNEL_DFREQ, DFREQ, -inf, inf);
+        for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+        {
+            if ((pmu_station->PHUNIT_get(k) >> 24) == 1)
+                add(s, pmu_station->PH_NAME_get(k) + DP_MAG_SUFFIX, CURRENT, -inf, current_max);
+            else
+                add(s, pmu_station->PH_NAME_get(k) + DP_MAG_SUFFIX, VOLTAGE, m_conf->get_voltage_min(), voltage_max);
+            add(s, pmu_station->PH_NAME_get(k) + DP_ANG_SUFFIX, ANGLE, -inf, inf);
+        }
+        for (int k = 0; k < pmu_station->ANNMR_get(); k++)
+            add(s, pmu_station->AN_NAME_get(k), ANALOG, -inf, inf);
+    }
+    m_offsets.push_back(m_labels.size());
+
+    size_t nb_channels = m_labels.size();
+    m_values.assign(nb_channels, 0);
+    m_previous_values.assign(nb_channels, 0);
+    m_frozen_counts.assign(nb_channels, 0);
+    m_flags.assign(nb_channels, 0);
+    m_counts.assign(nb_channels * BAD_NB_REASONS, 0);
+    m_total_counts.assign(nb_channels * BAD_NB_REASONS, 0);
+    m_bad_stations.assign(config_frame->pmu_station_list.size(), 0);
+    m_has_previous = false;
+    Logger::getLogger()->debug("Validation: %u channels in %u stations", (uint)nb_channels, (uint)m_idcodes.size());
+}
+
+/**
+ * @brief copy the values of the frame to the flat array, and apply the STAT of each station to its channels
+ */
+void FC37118Validation::m_gather(CONFIG_Frame *config_frame)
+{
+    for (size_t s = 0; s < m_idcodes.size(); s++)
+    {
+        auto pmu_station = config_frame->pmu_station_list[s];
+        double *values = m_values.data() + m_offsets[s];
+        *values++ = station_frequency(pmu_station);
+        *values++ = station_rocof(pmu_station);
+        for (int k = 0; k < pmu_station->PHNMR_get(); k++)
+        {
+            auto phasor = pmu_station->PHASOR_VALUE_get(k);
+            *values++ = std::abs(phasor);
+            *values++ = std::arg(phasor);
+        }
+        for (int k = 0; k < pmu_station->ANNMR_get(); k++)
+            *values++ = pmu_station->ANALOG_VALUE_get(k);
+
+        uint8_t stat_flag = (pmu_station->STAT_get() & m_conf->get_stat_mask()) ? BAD_STAT : 0;
+        std::fill(m_flags.begin() + m_offsets[s], m_flags.begin() + m_offsets[s + 1], stat_flag);
+    }
+}
+
+void FC37118Validation::evaluate(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time)
+{
+    if (config_version != m_config_version)
+    {
+        m_setup(config_frame);
+        m_config_version = config_version;
+    }
+    double dt = frame_time - m_previous_time;
+    bool is_step_checked = m_has_previous && dt > 0 && dt <= VALIDATION_MAX_GAP_S;
+    m_gather(config_frame);
+
+    size_t nb_channels = m_values.size();
+    const double *values = m_values.data();
+    const double *previous_values = m_previous_values.data();
+    uint8_t *flags = m_flags.data();
+
+    for (size_t c = 0; c < nb_channels; c++)
+    {
+        double value = values[c];
+        flags[c] |= (std::isnan(value) || std::isinf(value)) ? BAD_NAN : 0;
+        flags[c] |= (value < m_mins[c] || value > m_maxs[c]) ? BAD_RANGE : 0;
+    }
+
+    uint frozen_frames = m_conf->get_frozen_frames();
+    if (frozen_frames > 0 && m_has_previous)
+    {
+        for (size_t c = 0; c < nb_channels; c++)
+        {
+            if (m_kinds[c] != VOLTAGE && m_kinds[c] != CURRENT && m_kinds[c] != ANALOG)
+                continue;
+            m_frozen_counts[c] = values[c] == previous_values[c] ? m_frozen_counts[c] + 1 : 0;
+            flags[c] |= m_frozen_counts[c] >= frozen_frames ? BAD_FROZEN : 0;
+        }
+    }
+
+    if (is_step_checked)
+    {
+        double mag_step = m_conf->get_max_mag_step_percent() / 100;
+        double angle_step = m_conf->get_max_angle_step_deg() * M_PI / 180;
+        double freq_step = m_conf->get_max_freq_slope() * dt;
+        for (size_t c = 0; c < nb_channels; c++)
+        {
+            double step = values[c] - previous_values[c];
+            switch (m_kinds[c])
+            {
+            case VOLTAGE:
+            case CURRENT:
+                flags[c] |= (mag_step > 0 && std::abs(step) > mag_step * previous_values[c]) ? BAD_STEP : 0;
+                break;
+            case ANGLE:
+                if (angle_step > 0)
+                {
+                    // the FREQ channel is the first one of the station
+                    size_t s = m_stations[c];
+                    step -= 2 * M_PI * (values[m_offsets[s]] - m_fnoms[s]) * dt;
+                    step -= 2 * M_PI * std::round(step / (2 * M_PI));
+                    flags[c] |= std::abs(step) > angle_step ? BAD_STEP : 0;
+                }
+                break;
+            case FREQ:
+                flags[c] |= (freq_step > 0 && std::abs(step) > freq_step) ? BAD_STEP : 0;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    std::fill(m_bad_stations.begin(), m_bad_stations.end(), 0);
+    for (size_t c = 0; c < nb_channels; c++)
+    {
+        if (flags[c] == 0)
+            continue;
+        m_bad_stations[m_stations[c]] |= flags[c];
+        for (int r = 0; r < BAD_NB_REASONS; r++)
+        {
+            if (flags[c] & (1 << r))
+                m_counts[c * BAD_NB_REASONS + r]++;
+        }
+    }
+
+    m_values.swap(m_previous_values);
+    m_previous_time = frame_time;
+    m_has_previous = true;
+
+    if (m_conf->get_report_period() > 0 && std::chrono::steady_clock::now() >= m_next_report)
+    {
+        m_report();
+        m_next_report = std::chrono::steady_clock::now() + std::chrono::seconds(m_conf->get_report_period());
+    }
+}
+
+Datapoint *FC37118Validation::to_datapoint(size_t station)
+{
+    if (!is_bad(station))
+        return nullptr;
+    auto bad_dps = new std::vector<Datapoint *>;
+    for (size_t c = m_offsets[station]; c < m_offsets[station + 1]; c++)
+    {
+        if (m_flags[c] == 0)
+            continue;
+        auto dp_channel = create_dp(DP_BAD_CHANNEL, m_labels[c]);
+        auto dp_reason = create_dp(DP_BAD_REASON, to_reasons(m_flags[c]));
+        bad_dps->push_back(create_dp_list(DP_BAD_DATA, new std::vector<Datapoint *>({dp_channel, dp_reason}), true));
+    }
+    return create_dp_list(DP_BAD_DATA, bad_dps, false);
+}
+
+void FC37118Validation::m_report()
+{
+    std::vector<size_t> bad_channels;
+    for (size_t c = 0; c < m_labels.size(); c++)
+    {
+        if (std::any_of(m_counts.begin() + c * BAD_NB_REASONS, m_counts.begin() + (c + 1) * BAD_NB_REASONS, [](unsigned long n)
+                        { return n > 0; }))
+            bad_channels.push_back(c);
+    }
+    if (bad_channels.empty())
+        return;
+    Logger::getLogger()->warn("Validation: bad data on %u channels over the last %u s",
+                              (uint)bad_channels.size(), m_conf->get_report_period());
+    for (size_t i = 0; i < bad_channels.size(); i++)
+    {
+        size_t c = bad_channels[i];
+        std::string counts;
+        for (int r = 0; r < BAD_NB_REASONS; r++)
+        {
+            unsigned long &count = m_counts[c * BAD_NB_REASONS + r];
+            m_total_counts[c * BAD_NB_REASONS + r] += count;
+            if (count > 0 && i < VALIDATION_REPORT_MAX_CHANNELS)
+                counts += (counts.empty() ? "" : ", ") + std::to_string(count) + " " + bad_reasons[r] +
+                          " (" + std::to_string(m_total_counts[c * BAD_NB_REASONS + r]) + " since start)";
+            count = 0;
+        }
+        if (i < VALIDATION_REPORT_MAX_CHANNELS)
+            Logger::getLogger()->warn("  %u %s: " + counts, m_idcodes[m_stations[c]], m_labels[c].c_str());
+    }
+    if (bad_channels.size() > VALIDATION_REPORT_MAX_CHANNELS)
+        Logger::getLogger()->warn("  and %u more channels", (uint)(bad_channels.size() - VALIDATION_REPORT_MAX_CHANNELS));
+}
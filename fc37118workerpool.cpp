@@ -0,0 +1,132 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <cerrno>
+
+#include "fc37118workerpool.h"
+
+/**
+ * @brief set the affinity of a thread to a set of cpus
+ *
+ * @return true - affinity set
+ * @return false - the affinity could not be set, errno is set
+ */
+bool pin_thread(std::thread::native_handle_type thread, const std::vector<uint> &cpus)
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : cpus)
+        CPU_SET(cpu, &cpu_set);
+    int error = pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set);
+    errno = error;
+    return error == 0;
+}
+
+FC37118WorkerPool::FC37118WorkerPool() : m_stopping(false),
+                                         m_generation(0),
+                                         m_pending(0),
+                                         m_count(0),
+                                         m_task(nullptr)
+{
+}
+
+FC37118WorkerPool::~FC37118WorkerPool()
+{
+    stop();
+}
+
+void FC37118WorkerPool::start(uint nb_workers, const std::vector<uint> &cpus)
+{
+    stop();
+    m_stopping = false;
+    m_generation = 0;
+    for (uint w = 0; w < nb_workers; w++)
+    {
+        // shard 0 is processed by the calling thread
+        auto worker = new std::thread(&FC37118WorkerPool::m_work, this, w + 1);
+        if (!cpus.empty() && !pin_thread(worker->native_handle(), {cpus[w % cpus.size()]}))
+            Logger::getLogger()->warn("Unable to pin conversion worker %u to cpu %u", w, cpus[w % cpus.size()]);
+        m_workers.push_back(worker);
+    }
+    Logger::getLogger()->info("Conversion worker pool started with %u workers", nb_workers);
+}
+
+void FC37118WorkerPool::stop()
+{
+    if (m_workers.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_start_cv.notify_all();
+    for (auto worker : m_workers)
+    {
+        worker->join();
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+void FC37118WorkerPool::m_run_shard(size_t shard)
+{
+    size_t nb_shards = m_workers.size() + 1;
+    size_t begin = m_count * shard / nb_shards;
+    size_t end = m_count * (shard + 1) / nb_shards;
+    if (begin < end)
+        (*m_task)(begin, end);
+}
+
+void FC37118WorkerPool::run(size_t count, const Task &task)
+{
+    if (m_workers.empty())
+    {
+        task(0, count);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_pending = m_workers.size();
+        m_generation++;
+    }
+    m_start_cv.notify_all();
+
+    m_run_shard(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cv.wait(lock, [this]
+                   { return m_pending == 0; });
+    m_task = nullptr;
+}
+
+void FC37118WorkerPool::m_work(size_t shard)
+{
+    unsigned long generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_start_cv.wait(lock, [this, generation]
+                        { return m_stopping || m_generation != generation; });
+        if (m_stopping)
+            return;
+        generation = m_generation;
+
+        lock.unlock();
+        m_run_shard(shard);
+        lock.lock();
+
+        if (--m_pending == 0)
+            m_done_cv.notify_one();
+    }
+}
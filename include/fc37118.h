@@ -19,7 +19,10 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include <bitset>
+#include <cerrno>
+#include <mutex>
 
 
 #include "reading.h"
@@ -32,8 +35,30 @@
 #include "c37118command.h"
 
 #include "fc37118conf.h"
+#include "fc37118datapoint.h"
+#include "fc37118dictionary.h"
+#include "fc37118capture.h"
+#include "fc37118archive.h"
+#include "fc37118ingestqueue.h"
+#include "fc37118workerpool.h"
+#include "fc37118lowlatency.h"
+#include "fc37118derived.h"
+#include "fc37118validation.h"
+#include "fc37118oscillation.h"
+#include "fc37118angle.h"
+#include "fc37118trigger.h"
+#include "fc37118fastlane.h"
+#include "fc37118loadshedding.h"
+#include "fc37118chunk.h"
+#include "fc37118framereader.h"
+#include "fc37118tls.h"
+#include "fc37118path.h"
+#include "fc37118redundancy.h"
+#include "fc37118shm.h"
+#include "fc37118soak.h"
+#include "fc37118server.h"
+#include "fc37118probes.h"
 
-#define BUFFER_SIZE 80000
 
 #define C37118_CMD_TURNOFF_TX 0x01
 #define C37118_CMD_TURNON_TX 0x02
@@ -41,6 +66,17 @@
 #define C37118_CMD_SEND_CONFIGURATION_1 0x04
 #define C37118_CMD_SEND_CONFIGURATION_2 0x05
 
+#define C37118_FRAME_TYPE_DATA 0x0
+#define C37118_FRAME_TYPE_HEADER 0x1
+#define C37118_FRAME_TYPE_CONFIGURATION_1 0x2
+#define C37118_FRAME_TYPE_CONFIGURATION_2 0x3
+#define C37118_FRAME_TYPE_COMMAND 0x4
+
+#define REPLAY_SLEEP_SLICE_MS 100
+#define FRAME_ERROR_REPORT_PERIOD_S 10
+#define DIALOG_MAX_FRAMES 100
+#define DESYNC_SIZE_ERRORS 50
+
 #define PMU_DATA "PMU_data"
 
 #define DP_TIMESTAMP "TimeStamp"
@@ -101,29 +137,86 @@ private:
     // Running
     bool m_is_running;
     bool m_terminate();
-    std::thread *m_receiving_thread;
 
-    // Connection to PMU
-    int m_sockfd;
-    struct sockaddr_in m_serv_addr;
-    bool m_connect();
+    // Connections to PMU: the primary path, and the REDUNDANCY paths if any
+    std::vector<FC37118Path *> m_paths;
+    FC37118LowLatency m_low_latency;
+    FC37118Redundancy m_redundancy;
+    void m_clear_paths();
+    bool m_connect(FC37118Path *path);
+    void m_disconnect(FC37118Path *path);
+    int m_receive(FC37118Path *path, unsigned char *buffer, size_t size);
+
+    // Frame reassembly & validation
+    size_t m_expected_data_frame_size;
+    unsigned long m_expected_size_version;
+    int m_read_frame(FC37118Path *path, unsigned char **frame, size_t *size);
+    bool m_read_frame_of_type(FC37118Path *path, int type, unsigned char **frame, size_t *size);
+    bool m_check_data_frame(FC37118Path *path, size_t size);
+    void m_report_frame_errors(FC37118Path *path);
 
     // C37.118 objects handling
     CMD_Frame m_cmd;
+    std::mutex m_cmd_mutex;
     CONFIG_Frame *m_config_frame;
+    std::vector<unsigned char> m_config_frame_raw;
     DATA_Frame *m_data_frame;
+    unsigned long m_config_version;
     void m_init_c37118();
-    bool m_send_cmd(unsigned short cmd);
-    void m_init_Pmu_Dialog();
+    double m_frame_fraction();
+    bool m_send_cmd(FC37118Path *path, unsigned short cmd);
+    bool m_init_Pmu_Dialog(FC37118Path *path);
+    void m_install_config_frame(unsigned char *frame, size_t size, uint64_t arrival_ns);
+    void m_install_hard_config();
 
     // Fledge
-    std::vector<Reading *> m_dataframe_to_reading();
+    std::vector<FC37118Reading> m_dataframe_to_reading(bool is_flagged_only = false);
+
+    Datapoint *m_pmu_station_to_datapoint(PMU_Station *pmu_station, size_t index, const FC37118LoadLevelConf &level);
+    Datapoint *m_pmu_station_to_indexed_datapoint(PMU_Station *pmu_station, size_t index, const FC37118LoadLevelConf &level);
+    FC37118Dictionary m_dictionary;
+    unsigned long m_dictionary_config_version;
+    void m_publish_dictionary();
+    FC37118WorkerPool m_conversion_pool;
+
+    // Analysis stages
+    FC37118Derived m_derived;
+    FC37118Validation m_validation;
+    FC37118Oscillation m_oscillation;
+    FC37118AngleDifference m_angle_difference;
+    FC37118Trigger m_trigger;
+    FC37118Chunker m_chunker;
+
+    // Shared memory publication
+    FC37118ShmPublisher m_shm;
+
+    // Re-publication to downstream clients
+    FC37118Server m_server;
 
-    Datapoint *m_pmu_station_to_datapoint(PMU_Station *pmu_station);
+    // Memory soak monitoring
+    FC37118Soak m_soak;
 
     INGEST_CB m_ingest; // Callback function used to send data to south service
     void *m_data;       // Ingest function data
-    bool m_init_receiving();
-    void m_receiveAndPushDatapoints();
+    bool m_init_receiving(FC37118Path *path);
+    void m_receiveAndPushDatapoints(FC37118Path *path);
+    std::mutex m_process_mutex; // serialises the processing of the frames received by the paths
+    void m_process_data_frame(unsigned char *buffer, size_t size, uint64_t arrival_ns);
+    void m_process_replayed_frame(FC37118Path *path, unsigned char *frame, size_t size, bool *missing_config_logged);
+    void m_push(const FC37118Reading &reading);
+    FC37118IngestQueue m_ingest_queue;
+
+    // Priority lane for the frames carrying alarms, bypassing CHUNK, TRIGGER and the ingest queue
+    FC37118FastLane m_fast_lane;
+    void m_ingest_reading(const FC37118Reading &reading, FC37118Lane lane);
+
+    // Adaptive load shedding
+    FC37118LoadShedding m_load_shedding;
+
+    // Capture, archive & replay
+    FC37118CaptureWriter m_capture;
+    FC37118ArchiveWriter m_archive;
+    void m_capture_frame(const unsigned char *buffer, int size, uint64_t arrival_ns);
+    void m_replay(FC37118Path *path);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118ANGLE_H
+#define _F_C37118ANGLE_H
+
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+#include "fc37118channel.h"
+
+#define DP_ANGLE_DIFFERENCE "AngleDifference"
+#define DP_DIFFERENCES "Differences"
+#define DP_ALARMS "Alarms"
+
+/**
+ * @brief Angle differences between phasors of the stream, each one relative to its reference phasor,
+ * of the same station or of another station of a PDC stream.
+ * The difference is taken as the argument of P.conj(R), so it is always wrapped to ]-180, 180] degrees.
+ * An optional alarm per pair is raised over ALARM_DEG and cleared under ALARM_DEG - HYSTERESIS_DEG.
+ */
+class FC37118AngleDifference
+{
+public:
+    FC37118AngleDifference();
+    ~FC37118AngleDifference();
+
+    void configure(FC37118AngleDifferenceConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief compute the differences of the data frame last unpacked with config_frame
+     *
+     * @param fracsec fraction of second, without the time quality flags
+     * @return Reading* - the differences reading, nullptr when decimated out and no alarm changed
+     */
+    Reading *update(CONFIG_Frame *config_frame, unsigned long config_version, unsigned long soc, unsigned long fracsec);
+
+private:
+    struct Pair
+    {
+        FC37118AngleDifferencePairConf conf;
+        FC37118ChannelRef phasor;
+        FC37118ChannelRef reference;
+        double difference_deg;
+        bool is_alarm;
+    };
+
+    FC37118AngleDifferenceConf *m_conf;
+    unsigned long m_config_version;
+    std::vector<Pair> m_pairs;
+    unsigned long m_nb_frames;
+    unsigned short m_stream_idcode;
+
+    void m_setup(CONFIG_Frame *config_frame);
+    bool m_resolve(CONFIG_Frame *config_frame, const FC37118PhasorConf &phasor_conf, FC37118ChannelRef *ref);
+    bool m_update_alarm(Pair &pair);
+};
+
+#endif
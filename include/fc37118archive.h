@@ -0,0 +1,96 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118ARCHIVE_H
+#define _F_C37118ARCHIVE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "logger.h"
+#include "fc37118conf.h"
+#include "fc37118archivelayout.h"
+
+/**
+ * @brief Appends the raw frames to the segmented archive described in fc37118archivelayout.h.
+ * Frames are gathered in blocks, optionally compressed, and each block gets an entry of the sparse SOC index of its segment.
+ * Segments are rotated on size, duration and configuration change, and the oldest ones are removed beyond MAX_SIZE_MB.
+ * tools/archive extracts a time range as a capture file that REPLAY accepts.
+ */
+class FC37118ArchiveWriter
+{
+public:
+    FC37118ArchiveWriter();
+    ~FC37118ArchiveWriter();
+
+    void configure(FC37118ArchiveConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief create the directory if needed, and take the existing segments into account for MAX_SIZE_MB
+     */
+    bool open();
+
+    /**
+     * @brief write the current block and close the segment
+     */
+    void close();
+    bool is_open() { return m_is_open; }
+
+    /**
+     * @brief configuration frame to start the segments with, when it is not received in the stream
+     */
+    void set_config_frame(const unsigned char *frame, size_t size);
+
+    /**
+     * @brief archive a frame, a configuration frame different from the current one starts a new segment
+     */
+    void write(uint64_t arrival_ns, const unsigned char *frame, uint32_t size);
+
+private:
+    struct Segment
+    {
+        std::string path;
+        uint64_t size;
+    };
+
+    FC37118ArchiveConf *m_conf;
+    bool m_is_open;
+    bool m_is_compression;
+
+    std::deque<Segment> m_segments; // oldest first, the last one is being written
+    uint64_t m_total_size;
+    FILE *m_segment;
+    FILE *m_index;
+    uint32_t m_segment_first_soc;
+    uint64_t m_segment_size; // of the segment file, its index excluded
+
+    std::vector<unsigned char> m_config_frame;
+    uint64_t m_config_arrival_ns;
+
+    std::vector<unsigned char> m_block;
+    std::vector<unsigned char> m_stored;
+    uint32_t m_block_first_soc;
+    uint32_t m_block_last_soc;
+    uint32_t m_block_nb_frames;
+    bool m_missing_config_logged;
+
+    bool m_open_segment(uint32_t soc, uint64_t arrival_ns);
+    void m_close_segment();
+    bool m_write_block();
+    void m_append(uint64_t arrival_ns, const unsigned char *frame, uint32_t size);
+    void m_enforce_max_size();
+    void m_fail(const std::string &message);
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118ARCHIVELAYOUT_H
+#define _F_C37118ARCHIVELAYOUT_H
+
+/*
+ * Layout of the raw frame archive written by the plugin (ARCHIVE section), shared with the extractor.
+ * No dependency on Fledge nor Open-C37.118. Host byte order.
+ *
+ * The archive directory holds segments c37118_<first SOC>[_<n>].seg, each one with its index c37118_<first SOC>[_<n>].idx.
+ * Segment: | ARCHIVE_SEGMENT_MAGIC | block | block | ...
+ *   block: | FC37118ArchiveBlockHeader | stored_size bytes, zlib compressed or not |
+ *   once decompressed, a block is a sequence of capture records (see fc37118capture.h):
+ *   arrival time in ns since epoch (uint64) | frame size (uint32) | raw frame bytes
+ * Index: | ARCHIVE_INDEX_MAGIC | FC37118ArchiveIndexEntry per block, in the order of the segment |
+ *
+ * The first record of a segment is the c37.118 configuration frame of all its data frames: a configuration change starts
+ * a new segment. Blocks are written whole and the files are append only, so a segment and its index can be read while
+ * being written. The index can be rebuilt from the block headers.
+ */
+
+#include <cstdint>
+
+#define ARCHIVE_SEGMENT_MAGIC "C37ARS01"
+#define ARCHIVE_INDEX_MAGIC "C37ARI01"
+#define ARCHIVE_MAGIC_SIZE 8
+#define ARCHIVE_FILE_PREFIX "c37118_"
+#define ARCHIVE_SEGMENT_SUFFIX ".seg"
+#define ARCHIVE_INDEX_SUFFIX ".idx"
+#define ARCHIVE_RECORD_HEADER_SIZE 12
+#define ARCHIVE_MAX_BLOCK_SIZE (64 << 20)
+
+enum FC37118ArchiveCompression : uint32_t
+{
+    ARCHIVE_COMPRESSION_NONE = 0,
+    ARCHIVE_COMPRESSION_ZLIB = 1
+};
+
+struct FC37118ArchiveBlockHeader
+{
+    uint32_t first_soc;
+    uint32_t last_soc;
+    uint32_t nb_frames;
+    uint32_t compression;
+    uint32_t raw_size;
+    uint32_t stored_size;
+};
+
+struct FC37118ArchiveIndexEntry
+{
+    uint32_t first_soc;
+    uint32_t last_soc;
+    uint64_t offset; // of the block header in the segment
+};
+
+/**
+ * @brief SOC of a raw c37.118 frame
+ */
+inline uint32_t archive_frame_soc(const unsigned char *frame)
+{
+    return ((uint32_t)frame[6] << 24) | ((uint32_t)frame[7] << 16) | ((uint32_t)frame[8] << 8) | frame[9];
+}
+
+#endif
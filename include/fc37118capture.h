@@ -0,0 +1,73 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118CAPTURE_H
+#define _F_C37118CAPTURE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Capture file layout (host byte order):
+ *   file header: CAPTURE_MAGIC (8 bytes)
+ *   records:     arrival time in ns since epoch (uint64) | frame size (uint32) | raw frame bytes
+ */
+#define CAPTURE_MAGIC "C37CAP01"
+#define CAPTURE_MAGIC_SIZE 8
+#define CAPTURE_IO_BUFFER_SIZE (1 << 20)
+
+uint64_t capture_clock_ns();
+
+class FC37118CaptureWriter
+{
+public:
+    FC37118CaptureWriter();
+    ~FC37118CaptureWriter();
+
+    bool open(const std::string &path);
+    void close();
+    bool is_open() { return m_file != nullptr; }
+    bool write(uint64_t arrival_ns, const unsigned char *frame, uint32_t size);
+
+private:
+    FILE *m_file;
+    std::vector<char> m_io_buffer;
+};
+
+class FC37118CaptureReader
+{
+public:
+    FC37118CaptureReader();
+    ~FC37118CaptureReader();
+
+    bool open(const std::string &path);
+    void close();
+    bool rewind();
+
+    /**
+     * @brief read the next record of the capture file
+     *
+     * @param arrival_ns arrival timestamp of the frame
+     * @param buffer destination of the raw frame
+     * @param buffer_size size of buffer
+     * @param size size of the raw frame
+     * @return true - a frame was read
+     * @return false - end of file or corrupted record
+     */
+    bool next(uint64_t *arrival_ns, unsigned char *buffer, uint32_t buffer_size, uint32_t *size);
+
+private:
+    FILE *m_file;
+    std::vector<char> m_io_buffer;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118CHANNEL_H
+#define _F_C37118CHANNEL_H
+
+#include <string>
+
+#include "c37118configuration.h"
+
+#define CHANNEL_FREQ "FREQ"
+#define CHANNEL_DFREQ "DFREQ"
+
+/**
+ * @brief nominal frequency of the station, FNOM bit 0: 1 for 50 Hz, 0 for 60 Hz
+ */
+double station_fnom(PMU_Station *pmu_station);
+
+/**
+ * @brief frequency of the station in Hz, FREQ being the frequency in float format or the deviation from nominal in mHz in integer format
+ */
+double station_frequency(PMU_Station *pmu_station);
+
+/**
+ * @brief ROCOF of the station in Hz/s, DFREQ being scaled by 100 in integer format
+ */
+double station_rocof(PMU_Station *pmu_station);
+
+enum class ChannelKind
+{
+    NONE,
+    FREQ,
+    DFREQ,
+    PHASOR_MAGNITUDE,
+    PHASOR_ANGLE,
+    ANALOG
+};
+
+/**
+ * @brief reference to a measurement of a station in the c37.118 configuration, resolved from its name
+ */
+struct FC37118ChannelRef
+{
+    ChannelKind kind;
+    size_t station;
+    int index;
+
+    FC37118ChannelRef() : kind(ChannelKind::NONE), station(0), index(-1) {}
+
+    /**
+     * @brief resolve the channel of the station idcode
+     *
+     * @param name "FREQ", "DFREQ", a phasor name (PHNAM) or an analog name (ANNAM)
+     * @param is_angle for phasors, the angle is referenced instead of the magnitude
+     * @return true - channel found
+     * @return false - no such station or channel
+     */
+    bool resolve(CONFIG_Frame *config_frame, unsigned int idcode, const std::string &name, bool is_angle);
+    bool is_resolved() { return kind != ChannelKind::NONE; }
+
+    /**
+     * @brief value of the channel in the data frame last unpacked with config_frame
+     */
+    double value(CONFIG_Frame *config_frame);
+
+    std::string label(CONFIG_Frame *config_frame);
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118CHUNK_H
+#define _F_C37118CHUNK_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+#include "fc37118ingestqueue.h"
+
+#define DP_CHUNK "Chunk"
+#define DP_OFFSETS "Offset"
+#define DP_STAT "STAT"
+#define DP_MAG_SUFFIX ".Mag"
+#define DP_ANG_SUFFIX ".Ang"
+
+class FC37118Validation;
+
+/**
+ * @brief Columnar output: the frames of a station are collected into one reading per chunk of FRAMES frames
+ * (or DURATION_MS), holding the chunk SOC, an array of time offsets and one numeric array per channel.
+ * Chunks never span two seconds, so that their boundaries are aligned on SOC.
+ * With VALIDATION, a chunk gets a BadData list of the channels having bad values, with their reasons and the offsets of the
+ * frames concerned. In SUPPRESS mode the bad values are NaN in the arrays.
+ */
+class FC37118Chunker
+{
+public:
+    FC37118Chunker();
+    ~FC37118Chunker();
+
+    void configure(FC37118ChunkConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief append the data frame last unpacked with config_frame
+     *
+     * @param filter IDCODEs of the stations to output, all stations if empty
+     * @param validation validation of the frame, nullptr if disabled
+     * @param output completed chunk readings
+     * @param skipped IDCODEs of the stations not to append this frame for, if not null
+     */
+    void append(CONFIG_Frame *config_frame, unsigned long config_version, const std::vector<uint> &filter,
+                unsigned long soc, double fraction, FC37118Validation *validation, std::vector<FC37118Reading> &output,
+                const std::set<unsigned short> *skipped = nullptr);
+
+    /**
+     * @brief output the chunks in progress
+     */
+    void flush(std::vector<FC37118Reading> &output);
+
+private:
+    struct StationChunk
+    {
+        size_t station;
+        unsigned short idcode;
+        std::string asset;
+        std::string stn;
+        std::vector<std::string> labels;
+
+        bool is_open;
+        unsigned long soc;
+        long slot;
+        std::vector<double> offsets;
+        std::vector<double> stats;
+        std::vector<double> freqs;
+        std::vector<double> dfreqs;
+        std::vector<std::vector<double>> channels;
+        // per validation channel: FREQ, DFREQ, then the channels
+        std::vector<uint8_t> bad_reasons;
+        std::vector<std::vector<double>> bad_offsets;
+    };
+
+    FC37118ChunkConf *m_conf;
+    unsigned long m_config_version;
+    double m_duration;
+    std::vector<StationChunk> m_chunks;
+
+    void m_setup(CONFIG_Frame *config_frame, const std::vector<uint> &filter);
+    Reading *m_close(StationChunk &chunk);
+};
+
+#endif
@@ -25,6 +25,7 @@
 #define STREAMSOURCE_IDCODE "STREAMSOURCE_IDCODE"
 #define STN_IDCODES_FILTER "STATION_IDCODES_FILTER"
 #define SPLIT_STATIONS "SPLIT_STATIONS"
+#define DICTIONARY_LABELS "DICTIONARY_LABELS"
 
 #define REQUEST_CONFIG_TO_SENDER "REQUEST_CONFIG_TO_SENDER"
 #define SENDER_HARD_CONFIG "SENDER_HARD_CONFIG"
@@ -47,6 +48,166 @@
 #define CFGCNT "CFGCNT"
 #define DATA_RATE "DATA_RATE"
 
+#define CAPTURE "CAPTURE"
+#define CAPTURE_FILE "FILE"
+
+#define REPLAY "REPLAY"
+#define REPLAY_FILE "FILE"
+#define REPLAY_REALTIME "REALTIME"
+#define REPLAY_LOOPS "LOOPS"
+
+#define INGEST_QUEUE "INGEST_QUEUE"
+#define QUEUE_MAX_READINGS "MAX_READINGS"
+#define QUEUE_MAX_MEMORY_KB "MAX_MEMORY_KB"
+#define QUEUE_POLICY "POLICY"
+#define QUEUE_KEEP_NTH "KEEP_NTH"
+#define QUEUE_PRIORITY_IDCODES "PRIORITY_IDCODES"
+#define QUEUE_REPORT_PERIOD "REPORT_PERIOD"
+
+#define PARALLEL_CONVERSION "PARALLEL_CONVERSION"
+#define PARALLEL_WORKERS "WORKERS"
+#define PARALLEL_CPUS "CPUS"
+#define PARALLEL_MIN_STATIONS "MIN_STATIONS"
+
+#define LOW_LATENCY "LOW_LATENCY"
+#define LL_CPUS "CPUS"
+#define LL_SCHED_FIFO_PRIORITY "SCHED_FIFO_PRIORITY"
+#define LL_RCVBUF_KB "RCVBUF_KB"
+#define LL_TCP_NODELAY "TCP_NODELAY"
+#define LL_TCP_QUICKACK "TCP_QUICKACK"
+#define LL_BUSY_POLL_US "BUSY_POLL_US"
+#define LL_KERNEL_TIMESTAMPS "KERNEL_TIMESTAMPS"
+
+#define DERIVED "DERIVED"
+#define DERIVED_ROLES "ROLES"
+#define DERIVED_ROCOF "ROCOF"
+#define DERIVED_ROLE_VA "VA"
+#define DERIVED_ROLE_VB "VB"
+#define DERIVED_ROLE_VC "VC"
+#define DERIVED_ROLE_IA "IA"
+#define DERIVED_ROLE_IB "IB"
+#define DERIVED_ROLE_IC "IC"
+#define DERIVED_NB_ROLES 6
+
+#define OSCILLATION "OSCILLATION"
+#define OSC_WINDOW_S "WINDOW_S"
+#define OSC_SAMPLE_RATE "SAMPLE_RATE"
+#define OSC_MIN_FREQ "MIN_FREQ"
+#define OSC_MAX_FREQ "MAX_FREQ"
+#define OSC_EMIT_PERIOD_S "EMIT_PERIOD_S"
+#define OSC_CHANNELS "CHANNELS"
+#define OSC_CHANNEL "CHANNEL"
+#define OSC_QUANTITY "QUANTITY"
+
+#define OSC_QUANTITY_MAG "MAG"
+#define OSC_QUANTITY_ANG "ANG"
+
+#define TRIGGER "TRIGGER"
+#define TRG_OUTPUT_RATE "OUTPUT_RATE"
+#define TRG_PRE_FRAMES "PRE_FRAMES"
+#define TRG_POST_FRAMES "POST_FRAMES"
+#define TRG_FREQ_DEVIATION "FREQ_DEVIATION"
+#define TRG_ROCOF "ROCOF"
+#define TRG_VOLTAGE_SAG "VOLTAGE_SAG"
+#define TRG_ANGLE_JUMP "ANGLE_JUMP"
+#define TRG_VOLTAGE_CHANNELS "VOLTAGE_CHANNELS"
+#define TRG_STAT_MASK "STAT_MASK"
+
+#define CHUNK "CHUNK"
+#define CHUNK_FRAMES "FRAMES"
+#define CHUNK_DURATION_MS "DURATION_MS"
+
+#define TLS "TLS"
+#define TLS_CA_FILE "CA_FILE"
+#define TLS_CERT_FILE "CERT_FILE"
+#define TLS_KEY_FILE "KEY_FILE"
+#define TLS_SERVER_NAME "SERVER_NAME"
+#define TLS_PINNED_SHA256 "PINNED_SHA256"
+#define TLS_KTLS "KTLS"
+
+#define REDUNDANCY "REDUNDANCY"
+#define RED_PATHS "PATHS"
+#define RED_WINDOW_FRAMES "WINDOW_FRAMES"
+#define RED_REPORT_PERIOD "REPORT_PERIOD"
+#define RED_MAX_PATHS 32
+
+#define SHM "SHM"
+#define SHM_NAME "NAME"
+#define SHM_SLOTS "SLOTS"
+#define SHM_MAX_CHANNELS "MAX_CHANNELS"
+
+#define IO_URING "IO_URING"
+#define URING_BUFFERS "BUFFERS"
+#define URING_BUFFER_SIZE "BUFFER_SIZE"
+#define URING_MAX_BUFFERS 32768
+#define URING_MAX_BUFFER_SIZE 65536
+
+#define SOAK "SOAK"
+#define SOAK_SAMPLE_PERIOD_S "SAMPLE_PERIOD_S"
+#define SOAK_WARMUP_S "WARMUP_S"
+#define SOAK_MAX_GROWTH_KB "MAX_GROWTH_KB"
+
+#define ANGLE_DIFFERENCE "ANGLE_DIFFERENCE"
+#define ADIFF_REFERENCE "REFERENCE"
+#define ADIFF_PAIRS "PAIRS"
+#define ADIFF_CHANNEL "CHANNEL"
+#define ADIFF_NAME "NAME"
+#define ADIFF_ALARM_DEG "ALARM_DEG"
+#define ADIFF_HYSTERESIS_DEG "HYSTERESIS_DEG"
+#define ADIFF_DECIMATION "DECIMATION"
+
+#define SERVER "SERVER"
+#define SRV_MAX_CLIENTS "MAX_CLIENTS"
+#define SRV_QUEUE_FRAMES "QUEUE_FRAMES"
+
+#define ARCHIVE "ARCHIVE"
+#define ARC_DIRECTORY "DIRECTORY"
+#define ARC_SEGMENT_MB "SEGMENT_MB"
+#define ARC_SEGMENT_S "SEGMENT_S"
+#define ARC_MAX_SIZE_MB "MAX_SIZE_MB"
+#define ARC_BLOCK_KB "BLOCK_KB"
+#define ARC_INDEX_PERIOD_S "INDEX_PERIOD_S"
+#define ARC_COMPRESSION "COMPRESSION"
+#define ARC_COMPRESSION_NONE "NONE"
+#define ARC_COMPRESSION_ZLIB "ZLIB"
+
+#define FAST_LANE "FAST_LANE"
+#define FAST_STAT_MASK "STAT_MASK"
+#define FAST_FREQ_DEVIATION "FREQ_DEVIATION"
+#define FAST_ROCOF "ROCOF"
+#define FAST_REPORT_PERIOD "REPORT_PERIOD"
+
+#define LOAD_SHEDDING "LOAD_SHEDDING"
+#define SHED_BUDGET_PERCENT "BUDGET_PERCENT"
+#define SHED_OVERLOAD_S "OVERLOAD_S"
+#define SHED_RECOVERY_PERCENT "RECOVERY_PERCENT"
+#define SHED_RECOVERY_S "RECOVERY_S"
+#define SHED_LEVELS "LEVELS"
+#define SHED_DECIMATION "DECIMATION"
+#define SHED_MAX_PHASORS "MAX_PHASORS"
+#define SHED_MAX_ANALOGS "MAX_ANALOGS"
+#define SHED_COMPACT "COMPACT"
+
+#define VALIDATION "VALIDATION"
+#define VAL_MODE "MODE"
+#define VAL_VOLTAGE_MIN "VOLTAGE_MIN"
+#define VAL_VOLTAGE_MAX "VOLTAGE_MAX"
+#define VAL_CURRENT_MAX "CURRENT_MAX"
+#define VAL_FREQ_DEVIATION "FREQ_DEVIATION"
+#define VAL_FROZEN_FRAMES "FROZEN_FRAMES"
+#define VAL_MAX_MAG_STEP_PERCENT "MAX_MAG_STEP_PERCENT"
+#define VAL_MAX_ANGLE_STEP_DEG "MAX_ANGLE_STEP_DEG"
+#define VAL_MAX_FREQ_SLOPE "MAX_FREQ_SLOPE"
+#define VAL_STAT_MASK "STAT_MASK"
+#define VAL_REPORT_PERIOD "REPORT_PERIOD"
+#define VAL_MODE_ANNOTATE "ANNOTATE"
+#define VAL_MODE_SUPPRESS "SUPPRESS"
+
+#define QUEUE_POLICY_DROP_OLDEST "DROP_OLDEST"
+#define QUEUE_POLICY_DROP_NEWEST "DROP_NEWEST"
+#define QUEUE_POLICY_KEEP_NTH "KEEP_NTH"
+#define QUEUE_POLICY_PRIORITY "PRIORITY"
+
 class FC37118StnConf
 {
 public:
@@ -73,6 +234,593 @@ private:
     uint m_cfgcnt;
 };
 
+enum class QueuePolicy
+{
+    DROP_OLDEST,
+    DROP_NEWEST,
+    KEEP_NTH,
+    PRIORITY
+};
+
+class FC37118QueueConf
+{
+public:
+    FC37118QueueConf();
+    ~FC37118QueueConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    uint get_max_readings() { return m_max_readings; }
+    size_t get_max_memory() { return (size_t)m_max_memory_kb * 1024; }
+    QueuePolicy get_policy() { return m_policy; }
+    uint get_keep_nth() { return m_keep_nth; }
+    std::vector<uint> get_priority_idcodes() { return m_priority_idcodes; }
+    uint get_report_period() { return m_report_period; }
+
+private:
+    bool m_is_enabled;
+    uint m_max_readings;
+    uint m_max_memory_kb;
+    QueuePolicy m_policy;
+    uint m_keep_nth;
+    std::vector<uint> m_priority_idcodes;
+    uint m_report_period;
+};
+
+class FC37118ParallelConf
+{
+public:
+    FC37118ParallelConf();
+    ~FC37118ParallelConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_nb_workers > 0; }
+    uint get_nb_workers() { return m_nb_workers; }
+    std::vector<uint> get_cpus() { return m_cpus; }
+
+    /**
+     * @brief frames with fewer stations are converted by the receiving thread alone
+     */
+    uint get_min_stations() { return m_min_stations; }
+
+private:
+    uint m_nb_workers;
+    std::vector<uint> m_cpus;
+    uint m_min_stations;
+};
+
+/**
+ * @brief low latency profile of the receiving thread and of its socket, every setting is disabled by default
+ */
+class FC37118LowLatencyConf
+{
+public:
+    FC37118LowLatencyConf();
+    ~FC37118LowLatencyConf();
+
+    bool import(rapidjson::Value *value);
+    std::vector<uint> get_cpus() { return m_cpus; }
+    uint get_sched_fifo_priority() { return m_sched_fifo_priority; }
+    uint get_rcvbuf() { return m_rcvbuf_kb * 1024; }
+    bool is_tcp_nodelay() { return m_tcp_nodelay; }
+    bool is_tcp_quickack() { return m_tcp_quickack; }
+    uint get_busy_poll_us() { return m_busy_poll_us; }
+    bool is_kernel_timestamps() { return m_kernel_timestamps; }
+
+private:
+    std::vector<uint> m_cpus;
+    uint m_sched_fifo_priority;
+    uint m_rcvbuf_kb;
+    bool m_tcp_nodelay;
+    bool m_tcp_quickack;
+    uint m_busy_poll_us;
+    bool m_kernel_timestamps;
+};
+
+/**
+ * @brief phasor channel names playing the VA, VB, VC, IA, IB, IC roles.
+ * Without STN_IDCODE the roles apply to every station that has no roles of its own.
+ */
+struct FC37118DerivedRoles
+{
+    bool has_idcode;
+    uint idcode;
+    std::string names[DERIVED_NB_ROLES];
+};
+
+class FC37118DerivedConf
+{
+public:
+    FC37118DerivedConf();
+    ~FC37118DerivedConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    bool is_rocof() { return m_rocof; }
+    std::vector<FC37118DerivedRoles> get_roles() { return m_roles; }
+
+private:
+    bool m_is_enabled;
+    bool m_rocof;
+    std::vector<FC37118DerivedRoles> m_roles;
+};
+
+/**
+ * @brief a monitored channel: FREQ, a phasor (magnitude or angle) or an analog, by name
+ */
+struct FC37118OscillationChannelConf
+{
+    uint idcode;
+    std::string channel;
+    std::string quantity;
+};
+
+class FC37118OscillationConf
+{
+public:
+    FC37118OscillationConf();
+    ~FC37118OscillationConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    uint get_window_s() { return m_window_s; }
+    uint get_sample_rate() { return m_sample_rate; }
+    double get_min_freq() { return m_min_freq; }
+    double get_max_freq() { return m_max_freq; }
+    uint get_emit_period_s() { return m_emit_period_s; }
+    std::vector<FC37118OscillationChannelConf> get_channels() { return m_channels; }
+
+private:
+    bool m_is_enabled;
+    uint m_window_s;
+    uint m_sample_rate;
+    double m_min_freq;
+    double m_max_freq;
+    uint m_emit_period_s;
+    std::vector<FC37118OscillationChannelConf> m_channels;
+};
+
+/**
+ * @brief trigger rules, a threshold of 0 disables its rule
+ */
+class FC37118TriggerConf
+{
+public:
+    FC37118TriggerConf();
+    ~FC37118TriggerConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    double get_output_rate() { return m_output_rate; }
+    uint get_pre_frames() { return m_pre_frames; }
+    uint get_post_frames() { return m_post_frames; }
+    double get_freq_deviation() { return m_freq_deviation; }
+    double get_rocof() { return m_rocof; }
+    double get_voltage_sag() { return m_voltage_sag; }
+    double get_angle_jump() { return m_angle_jump; }
+    std::vector<std::string> get_voltage_channels() { return m_voltage_channels; }
+    uint get_stat_mask() { return m_stat_mask; }
+
+private:
+    bool m_is_enabled;
+    double m_output_rate;
+    uint m_pre_frames;
+    uint m_post_frames;
+    double m_freq_deviation;
+    double m_rocof;
+    double m_voltage_sag;
+    double m_angle_jump;
+    std::vector<std::string> m_voltage_channels;
+    uint m_stat_mask;
+};
+
+class FC37118ChunkConf
+{
+public:
+    FC37118ChunkConf();
+    ~FC37118ChunkConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    uint get_frames() { return m_frames; }
+
+    /**
+     * @brief if not 0, takes precedence over FRAMES
+     */
+    uint get_duration_ms() { return m_duration_ms; }
+
+private:
+    bool m_is_enabled;
+    uint m_frames;
+    uint m_duration_ms;
+};
+
+class FC37118TlsConf
+{
+public:
+    FC37118TlsConf();
+    ~FC37118TlsConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    std::string get_ca_file() { return m_ca_file; }
+    std::string get_cert_file() { return m_cert_file; }
+    std::string get_key_file() { return m_key_file; }
+
+    /**
+     * @brief if not empty, the name the PMU certificate shall be issued for
+     */
+    std::string get_server_name() { return m_server_name; }
+
+    /**
+     * @brief SHA-256 fingerprints (hex) the PMU certificate shall match, if not empty
+     */
+    std::vector<std::string> get_pinned_sha256() { return m_pinned_sha256; }
+    bool is_ktls() { return m_ktls; }
+
+private:
+    bool m_is_enabled;
+    std::string m_ca_file;
+    std::string m_cert_file;
+    std::string m_key_file;
+    std::string m_server_name;
+    std::vector<std::string> m_pinned_sha256;
+    bool m_ktls;
+};
+
+/**
+ * @brief an additional connection to an equivalent stream source
+ */
+struct FC37118PathConf
+{
+    std::string ip_addr;
+    uint port;
+};
+
+class FC37118RedundancyConf
+{
+public:
+    FC37118RedundancyConf();
+    ~FC37118RedundancyConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    std::vector<FC37118PathConf> get_paths() { return m_paths; }
+
+    /**
+     * @brief number of recent frames remembered to recognise the copies received on the other paths
+     */
+    uint get_window_frames() { return m_window_frames; }
+    uint get_report_period() { return m_report_period; }
+
+private:
+    bool m_is_enabled;
+    std::vector<FC37118PathConf> m_paths;
+    uint m_window_frames;
+    uint m_report_period;
+};
+
+class FC37118ShmConf
+{
+public:
+    FC37118ShmConf();
+    ~FC37118ShmConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+
+    /**
+     * @brief POSIX shared memory object name, starting with '/'
+     */
+    std::string get_name() { return m_name; }
+    uint get_slots() { return m_slots; }
+
+    /**
+     * @brief capacity of each slot, so that the segment size does not depend on the c37.118 configuration
+     */
+    uint get_max_channels() { return m_max_channels; }
+
+private:
+    bool m_is_enabled;
+    std::string m_name;
+    uint m_slots;
+    uint m_max_channels;
+};
+
+class FC37118UringConf
+{
+public:
+    FC37118UringConf();
+    ~FC37118UringConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+
+    /**
+     * @brief number of buffers of the provided buffer ring, power of 2
+     */
+    uint get_buffers() { return m_buffers; }
+    uint get_buffer_size() { return m_buffer_size; }
+
+private:
+    bool m_is_enabled;
+    uint m_buffers;
+    uint m_buffer_size;
+};
+
+class FC37118SoakConf
+{
+public:
+    FC37118SoakConf();
+    ~FC37118SoakConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    uint get_sample_period_s() { return m_sample_period_s; }
+
+    /**
+     * @brief duration before the memory baseline is taken, for caches and pools to reach their steady state
+     */
+    uint get_warmup_s() { return m_warmup_s; }
+    uint get_max_growth_kb() { return m_max_growth_kb; }
+
+private:
+    bool m_is_enabled;
+    uint m_sample_period_s;
+    uint m_warmup_s;
+    uint m_max_growth_kb;
+};
+
+/**
+ * @brief a phasor of a station, by name
+ */
+struct FC37118PhasorConf
+{
+    uint idcode;
+    std::string channel;
+};
+
+/**
+ * @brief angle difference of a phasor to its reference, ALARM_DEG 0 for no alarm
+ */
+struct FC37118AngleDifferencePairConf
+{
+    std::string name;
+    FC37118PhasorConf phasor;
+    FC37118PhasorConf reference;
+    double alarm_deg;
+};
+
+class FC37118AngleDifferenceConf
+{
+public:
+    FC37118AngleDifferenceConf();
+    ~FC37118AngleDifferenceConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    std::vector<FC37118AngleDifferencePairConf> get_pairs() { return m_pairs; }
+
+    /**
+     * @brief an alarm is cleared once the difference is back under ALARM_DEG - HYSTERESIS_DEG
+     */
+    double get_hysteresis_deg() { return m_hysteresis_deg; }
+
+    /**
+     * @brief one reading every DECIMATION frames, and on each alarm change
+     */
+    uint get_decimation() { return m_decimation; }
+
+private:
+    bool m_is_enabled;
+    double m_hysteresis_deg;
+    uint m_decimation;
+    std::vector<FC37118AngleDifferencePairConf> m_pairs;
+
+    bool m_import_phasor(rapidjson::Value *value, FC37118PhasorConf *phasor);
+};
+
+class FC37118ServerConf
+{
+public:
+    FC37118ServerConf();
+    ~FC37118ServerConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    std::string get_ip_addr() { return m_ip_addr; }
+    uint get_port() { return m_port; }
+    uint get_max_clients() { return m_max_clients; }
+
+    /**
+     * @brief frames waiting to be sent to a client, beyond which the new frames are dropped for this client
+     */
+    uint get_queue_frames() { return m_queue_frames; }
+
+private:
+    bool m_is_enabled;
+    std::string m_ip_addr;
+    uint m_port;
+    uint m_max_clients;
+    uint m_queue_frames;
+};
+
+class FC37118ArchiveConf
+{
+public:
+    FC37118ArchiveConf();
+    ~FC37118ArchiveConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+    std::string get_directory() { return m_directory; }
+
+    /**
+     * @brief a segment is closed once it reaches SEGMENT_MB or spans SEGMENT_S, and on each configuration change
+     */
+    uint64_t get_segment_size() { return (uint64_t)m_segment_mb << 20; }
+    uint get_segment_s() { return m_segment_s; }
+
+    /**
+     * @brief the oldest segments are removed while the archive exceeds MAX_SIZE_MB, 0 for no limit
+     */
+    uint64_t get_max_size() { return (uint64_t)m_max_size_mb << 20; }
+
+    /**
+     * @brief a block, the unit of compression and of the SOC index, holds up to BLOCK_KB of frames over up to INDEX_PERIOD_S
+     */
+    uint get_block_size() { return m_block_kb * 1024; }
+    uint get_index_period_s() { return m_index_period_s; }
+    bool is_compression() { return m_compression == ARC_COMPRESSION_ZLIB; }
+
+private:
+    bool m_is_enabled;
+    std::string m_directory;
+    uint m_segment_mb;
+    uint m_segment_s;
+    uint m_max_size_mb;
+    uint m_block_kb;
+    uint m_index_period_s;
+    std::string m_compression;
+};
+
+class FC37118FastLaneConf
+{
+public:
+    FC37118FastLaneConf();
+    ~FC37118FastLaneConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+
+    /**
+     * @brief a station is flagged when its STAT has one of these bits set, or its frequency deviation or ROCOF
+     * exceeds the thresholds (0 to disable them)
+     */
+    uint get_stat_mask() { return m_stat_mask; }
+    double get_freq_deviation() { return m_freq_deviation; }
+    double get_rocof() { return m_rocof; }
+
+    /**
+     * @brief period of the latency statistics of each lane in seconds, 0 to disable them
+     */
+    uint get_report_period() { return m_report_period; }
+
+private:
+    bool m_is_enabled;
+    uint m_stat_mask;
+    double m_freq_deviation;
+    double m_rocof;
+    uint m_report_period;
+};
+
+/**
+ * @brief output of a load shedding level: one frame out of DECIMATION, the first MAX_PHASORS phasors and MAX_ANALOGS analogs
+ * of each station (-1 for all), and the DICTIONARY_LABELS form of the readings if COMPACT. The default is the full output.
+ */
+struct FC37118LoadLevelConf
+{
+    uint decimation;
+    int max_phasors;
+    int max_analogs;
+    bool is_compact;
+
+    FC37118LoadLevelConf() : decimation(1), max_phasors(-1), max_analogs(-1), is_compact(false) {}
+};
+
+class FC37118LoadSheddingConf
+{
+public:
+    FC37118LoadSheddingConf();
+    ~FC37118LoadSheddingConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+
+    /**
+     * @brief share of the frame period (from DATA_RATE) the processing of a frame may take
+     */
+    double get_budget_percent() { return m_budget_percent; }
+
+    /**
+     * @brief the next level is entered once the budget is exceeded for OVERLOAD_S, the previous one once the processing
+     * takes less than RECOVERY_PERCENT of the budget for RECOVERY_S
+     */
+    uint get_overload_s() { return m_overload_s; }
+    double get_recovery_percent() { return m_recovery_percent; }
+    uint get_recovery_s() { return m_recovery_s; }
+
+    /**
+     * @brief the degradation levels, from the lightest to the heaviest, the full output being level 0
+     */
+    std::vector<FC37118LoadLevelConf> get_levels() { return m_levels; }
+
+private:
+    bool m_is_enabled;
+    double m_budget_percent;
+    uint m_overload_s;
+    double m_recovery_percent;
+    uint m_recovery_s;
+    std::vector<FC37118LoadLevelConf> m_levels;
+};
+
+class FC37118ValidationConf
+{
+public:
+    FC37118ValidationConf();
+    ~FC37118ValidationConf();
+
+    bool import(rapidjson::Value *value);
+    bool is_enabled() { return m_is_enabled; }
+
+    /**
+     * @brief if true the invalid values are left out of the readings, otherwise they are annotated
+     */
+    bool is_suppress() { return m_mode == VAL_MODE_SUPPRESS; }
+
+    /**
+     * @brief ranges of the voltage and current magnitudes, in the units of the data frames, and maximum deviation of the
+     * frequency from nominal in Hz, 0 to disable a bound
+     */
+    double get_voltage_min() { return m_voltage_min; }
+    double get_voltage_max() { return m_voltage_max; }
+    double get_current_max() { return m_current_max; }
+    double get_freq_deviation() { return m_freq_deviation; }
+
+    /**
+     * @brief a magnitude or an analog repeated identically over FROZEN_FRAMES frames is frozen, 0 to disable
+     */
+    uint get_frozen_frames() { return m_frozen_frames; }
+
+    /**
+     * @brief maximum change between two frames: of a magnitude in percent, of an angle in degrees once the rotation due to
+     * the frequency deviation is removed, of the frequency in Hz/s, 0 to disable
+     */
+    double get_max_mag_step_percent() { return m_max_mag_step_percent; }
+    double get_max_angle_step_deg() { return m_max_angle_step_deg; }
+    double get_max_freq_slope() { return m_max_freq_slope; }
+
+    /**
+     * @brief all the values of a station whose STAT has one of these bits set are invalid
+     */
+    uint get_stat_mask() { return m_stat_mask; }
+    uint get_report_period() { return m_report_period; }
+
+private:
+    bool m_is_enabled;
+    std::string m_mode;
+    double m_voltage_min;
+    double m_voltage_max;
+    double m_current_max;
+    double m_freq_deviation;
+    uint m_frozen_frames;
+    double m_max_mag_step_percent;
+    double m_max_angle_step_deg;
+    double m_max_freq_slope;
+    uint m_stat_mask;
+    uint m_report_period;
+};
+
 class FC37118Conf
 {
 public:
@@ -84,6 +832,12 @@ public:
     bool is_complete() { return m_is_complete; }
     bool is_split_stations() { return m_is_split_stations; }
 
+    /**
+     * @brief if true, the labels are published in a dictionary reading on each configuration change,
+     * and the data readings refer to the stations and channels by index
+     */
+    bool is_dictionary_labels() { return m_is_dictionary_labels; }
+
     std::string get_pmu_IP_addr() { return m_pmu_IP_addr; }
     uint get_pmu_port() { return m_pmu_IP_port; }
     uint get_pmu_IDCODE() { return m_pmu_IDCODE; }
@@ -103,9 +857,44 @@ public:
 
     void to_conf_frame(CONFIG_Frame *conf_frame);
 
+    bool is_capture() { return !m_capture_file.empty(); }
+    std::string get_capture_file() { return m_capture_file; }
+
+    /**
+     * @brief if true, the frames are read from the REPLAY file instead of the PMU connection
+     */
+    bool is_replay() { return !m_replay_file.empty(); }
+    std::string get_replay_file() { return m_replay_file; }
+    bool is_replay_realtime() { return m_replay_realtime; }
+
+    /**
+     * @brief number of times the REPLAY file is replayed, 0 for endless
+     */
+    uint get_replay_loops() { return m_replay_loops; }
+
+    FC37118QueueConf *get_queue_conf() { return &m_queue_conf; }
+    FC37118ParallelConf *get_parallel_conf() { return &m_parallel_conf; }
+    FC37118LowLatencyConf *get_low_latency_conf() { return &m_low_latency_conf; }
+    FC37118DerivedConf *get_derived_conf() { return &m_derived_conf; }
+    FC37118OscillationConf *get_oscillation_conf() { return &m_oscillation_conf; }
+    FC37118TriggerConf *get_trigger_conf() { return &m_trigger_conf; }
+    FC37118ChunkConf *get_chunk_conf() { return &m_chunk_conf; }
+    FC37118TlsConf *get_tls_conf() { return &m_tls_conf; }
+    FC37118RedundancyConf *get_redundancy_conf() { return &m_redundancy_conf; }
+    FC37118ShmConf *get_shm_conf() { return &m_shm_conf; }
+    FC37118SoakConf *get_soak_conf() { return &m_soak_conf; }
+    FC37118UringConf *get_uring_conf() { return &m_uring_conf; }
+    FC37118AngleDifferenceConf *get_angle_difference_conf() { return &m_angle_difference_conf; }
+    FC37118ServerConf *get_server_conf() { return &m_server_conf; }
+    FC37118ArchiveConf *get_archive_conf() { return &m_archive_conf; }
+    FC37118FastLaneConf *get_fast_lane_conf() { return &m_fast_lane_conf; }
+    FC37118LoadSheddingConf *get_load_shedding_conf() { return &m_load_shedding_conf; }
+    FC37118ValidationConf *get_validation_conf() { return &m_validation_conf; }
+
 private:
     bool m_is_complete;
     bool m_is_split_stations;
+    bool m_is_dictionary_labels;
     vector<unsigned int> m_stn_idcodes_filter;
 
     // connection parameters
@@ -122,6 +911,32 @@ private:
     uint m_time_base;
     int m_data_rate;
     std::vector<FC37118StnConf> m_stns;
+
+    // capture & replay
+    std::string m_capture_file;
+    std::string m_replay_file;
+    bool m_replay_realtime;
+    uint m_replay_loops;
+    void m_import_capture_replay(rapidjson::Value *doc);
+
+    FC37118QueueConf m_queue_conf;
+    FC37118ParallelConf m_parallel_conf;
+    FC37118LowLatencyConf m_low_latency_conf;
+    FC37118DerivedConf m_derived_conf;
+    FC37118OscillationConf m_oscillation_conf;
+    FC37118TriggerConf m_trigger_conf;
+    FC37118ChunkConf m_chunk_conf;
+    FC37118TlsConf m_tls_conf;
+    FC37118RedundancyConf m_redundancy_conf;
+    FC37118ShmConf m_shm_conf;
+    FC37118SoakConf m_soak_conf;
+    FC37118UringConf m_uring_conf;
+    FC37118AngleDifferenceConf m_angle_difference_conf;
+    FC37118ServerConf m_server_conf;
+    FC37118ArchiveConf m_archive_conf;
+    FC37118FastLaneConf m_fast_lane_conf;
+    FC37118LoadSheddingConf m_load_shedding_conf;
+    FC37118ValidationConf m_validation_conf;
 };
 
 #endif
@@ -0,0 +1,47 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118DATAPOINT_H
+#define _F_C37118DATAPOINT_H
+
+#include <string>
+#include <vector>
+
+#include "reading.h"
+
+template <typename T>
+inline Datapoint *create_dp(const std::string &name, const T &value)
+{
+    auto dpv = DatapointValue(value);
+    return new Datapoint(name, dpv);
+}
+
+inline Datapoint *create_dp_bool(const std::string &name, const bool &value)
+{
+    auto dpv = DatapointValue(value ? "true" : "false");
+    return new Datapoint(name, dpv);
+}
+
+/**
+ * @brief Create a composed data point object
+ *
+ * @param name
+ * @param dps a Datapoint vector
+ * @param is_dict true: is a dict, false: is a list
+ * @return Datapoint*
+ */
+inline Datapoint *create_dp_list(const std::string &name, std::vector<Datapoint *> *dps, bool is_dict)
+{
+    auto dpv = DatapointValue(dps, is_dict);
+
+    return new Datapoint(name, dpv);
+}
+
+#endif
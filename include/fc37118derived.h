@@ -0,0 +1,105 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118DERIVED_H
+#define _F_C37118DERIVED_H
+
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+
+#define DP_DERIVED "Derived"
+#define DP_V0 "V0"
+#define DP_V1 "V1"
+#define DP_V2 "V2"
+#define DP_I0 "I0"
+#define DP_I1 "I1"
+#define DP_I2 "I2"
+#define DP_ACTIVE_POWER "P"
+#define DP_REACTIVE_POWER "Q"
+#define DP_APPARENT_POWER "S"
+#define DP_PHASE_A "A"
+#define DP_PHASE_B "B"
+#define DP_PHASE_C "C"
+#define DP_TOTAL "Total"
+#define DP_ANGLE_FREQUENCY "AngleFrequency"
+#define DP_ANGLE_ROCOF "AngleROCOF"
+
+#define DERIVED_NB_SEQUENCES 6
+#define DERIVED_NB_POWERS 4
+
+/**
+ * @brief Derived electrical quantities computed from the decoded phasors:
+ * sequence components, active/reactive/apparent power per phase and total,
+ * frequency and ROCOF derived from the unwrapped angle.
+ * Values are stored as structures of arrays with one slot per station so that the computations vectorize across stations.
+ */
+class FC37118Derived
+{
+public:
+    FC37118Derived();
+    ~FC37118Derived();
+
+    void configure(FC37118DerivedConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief compute the derived quantities of the data frame last unpacked with config_frame
+     *
+     * @param config_version changes each time the c37.118 configuration is replaced, to resolve the roles again
+     * @param frame_time time of the data frame in seconds
+     */
+    void compute(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time);
+
+    /**
+     * @brief build the derived datapoint of a station
+     *
+     * @param station index of the station in the configuration frame
+     * @return Datapoint* - nullptr if no role is assigned for the station
+     */
+    Datapoint *to_datapoint(size_t station);
+
+private:
+    FC37118DerivedConf *m_conf;
+    unsigned long m_config_version;
+    size_t m_nb_stations;
+
+    // phasor index of each role for each station, -1 if not assigned
+    std::vector<int> m_channels[DERIVED_NB_ROLES];
+    std::vector<char> m_has_voltages;
+    std::vector<char> m_has_currents;
+    std::vector<char> m_has_roles;
+
+    std::vector<float> m_re[DERIVED_NB_ROLES];
+    std::vector<float> m_im[DERIVED_NB_ROLES];
+    std::vector<float> m_seq_re[DERIVED_NB_SEQUENCES];
+    std::vector<float> m_seq_im[DERIVED_NB_SEQUENCES];
+    std::vector<float> m_p[DERIVED_NB_POWERS];
+    std::vector<float> m_q[DERIVED_NB_POWERS];
+
+    // angle derived frequency
+    std::vector<double> m_fnom;
+    std::vector<double> m_prev_angle;
+    std::vector<double> m_freq;
+    std::vector<double> m_rocof;
+    std::vector<char> m_history;
+    double m_prev_time;
+
+    void m_resolve_roles(CONFIG_Frame *config_frame);
+    void m_gather(CONFIG_Frame *config_frame);
+    void m_compute_sequences(int first_role, int first_sequence);
+    void m_compute_powers();
+    void m_compute_frequencies(double frame_time);
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118DICTIONARY_H
+#define _F_C37118DICTIONARY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "reading.h"
+#include "c37118configuration.h"
+
+#define DP_DICTIONARY "Dictionary"
+#define DP_CONFIG_VERSION "ConfigVersion"
+#define DP_STATION_INDEX "Index"
+#define DP_DICT_IDCODE "IDCODE"
+#define DP_DICT_STN "STN"
+#define DP_DICT_FORMAT "FORMAT"
+#define DP_DICT_FNOM "FNOM"
+#define DP_DICT_CFGCNT "CFGCNT"
+#define DP_DICT_TIME_BASE "TIME_BASE"
+#define DP_DICT_DATA_RATE "DATA_RATE"
+#define DP_DICT_STATIONS "PMUStations"
+#define DP_DICT_STATION "Station"
+#define DP_DICT_CHANNEL "Channel"
+#define DP_DICT_PHASORS "Phasors"
+#define DP_DICT_ANALOGS "Analogs"
+#define DP_DICT_LABEL "Label"
+#define DP_DICT_TYPE "Type"
+#define DP_DICT_SCALE "Scale"
+
+/**
+ * @brief Labels of the c37.118 configuration, published once per configuration (DICTIONARY_LABELS).
+ * The <STREAMSOURCE_IDCODE>-Dictionary reading lists the stations (after STATION_IDCODES_FILTER) with their index in the
+ * configuration, name, FORMAT, nominal frequency, CFGCNT, and the label and unit of each phasor and analog in data frame order.
+ * Its ConfigVersion, a hash of the configuration frame, tags the data readings built with this configuration.
+ */
+class FC37118Dictionary
+{
+public:
+    FC37118Dictionary();
+    ~FC37118Dictionary();
+
+    /**
+     * @brief take a new configuration into account
+     *
+     * @param frame the raw configuration frame config_frame was unpacked from, or packed to
+     * @return the dictionary reading to ingest
+     */
+    Reading *update(CONFIG_Frame *config_frame, const unsigned char *frame, size_t size, const std::vector<unsigned int> &stn_filter);
+
+    /**
+     * @brief version of the current dictionary, FNV-1a of the configuration frame, timestamp and CHK excluded
+     */
+    long get_version() { return m_version; }
+
+private:
+    long m_version;
+
+    Datapoint *m_station_to_datapoint(PMU_Station *pmu_station, size_t index);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118FASTLANE_H
+#define _F_C37118FASTLANE_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+
+// latency histogram: bucket n counts the latencies below 2^n us
+#define FAST_LANE_LATENCY_BUCKETS 32
+
+enum class FC37118Lane
+{
+    FAST,
+    BULK
+};
+
+/**
+ * @brief Priority classification of the data frames, right after unpacking.
+ * A station is flagged when its STAT carries one of the STAT_MASK bits (data error, PMU trigger by default) or when its
+ * frequency deviation or ROCOF crosses the thresholds. The readings of the flagged stations, and the Multi_PMU reading of a
+ * frame with a flagged station, skip the chunks, the trigger decimation and the ingest queue: they are ingested at once.
+ * The latency from frame arrival to the end of the ingest callback is measured on both lanes and reported every REPORT_PERIOD.
+ */
+class FC37118FastLane
+{
+public:
+    FC37118FastLane();
+    ~FC37118FastLane();
+
+    void configure(FC37118FastLaneConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief classify the data frame last unpacked with config_frame, the stations out of stn_filter are ignored
+     *
+     * @return true - at least one station is flagged
+     */
+    bool classify(CONFIG_Frame *config_frame, const std::vector<unsigned int> &stn_filter);
+
+    /**
+     * @brief whether the reading of idcode (station, or stream source for Multi_PMU readings) of the last classified frame is flagged
+     */
+    bool is_flagged(unsigned short idcode) { return m_flagged.count(idcode) > 0; }
+
+    /**
+     * @brief IDCODEs of the flagged stations of the last classified frame
+     */
+    const std::set<unsigned short> &get_flagged_stations() { return m_flagged_stations; }
+
+    /**
+     * @brief account for a reading ingested on lane, thread safe
+     *
+     * @param arrival_ns arrival of the frame it was built from, 0 if unknown
+     */
+    void record(FC37118Lane lane, uint64_t arrival_ns);
+
+private:
+    struct LaneStats
+    {
+        unsigned long count;
+        double sum_us;
+        double max_us;
+        unsigned long buckets[FAST_LANE_LATENCY_BUCKETS];
+    };
+
+    FC37118FastLaneConf *m_conf;
+    std::set<unsigned short> m_flagged;
+    std::set<unsigned short> m_flagged_stations;
+    std::atomic<unsigned long> m_nb_flagged_frames;
+
+    std::mutex m_stats_mutex;
+    LaneStats m_stats[2];
+    std::chrono::steady_clock::time_point m_next_report;
+
+    void m_clear_stats();
+    void m_report();
+};
+
+#endif
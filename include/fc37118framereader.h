@@ -0,0 +1,99 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118FRAMEREADER_H
+#define _F_C37118FRAMEREADER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "c37118configuration.h"
+
+#define C37118_SYNC_BYTE 0xAA
+// SYNC, FRAMESIZE, IDCODE, SOC, FRACSEC and CHK
+#define C37118_MIN_FRAME_SIZE 16
+#define C37118_MAX_FRAME_SIZE 65535
+#define FRAME_READER_BUFFER_SIZE (4 * (C37118_MAX_FRAME_SIZE + 1))
+
+/**
+ * @brief CRC-CCITT of C37.118 frames (polynomial 0x1021, initial value 0xFFFF), table driven, slice by 8
+ */
+uint16_t crc_ccitt(const unsigned char *data, size_t size);
+
+/**
+ * @brief type of a frame, from the SYNC word
+ */
+inline int frame_type(const unsigned char *frame)
+{
+    return (frame[1] >> 4) & 0x07;
+}
+
+/**
+ * @brief size of the data frames described by a configuration frame
+ */
+size_t expected_data_frame_size(CONFIG_Frame *config_frame);
+
+/**
+ * @brief Reassembles the C37.118 frames of a byte stream.
+ * Bytes are read directly in the reader buffer (write_ptr/commit) and complete frames are returned in place.
+ * Bytes received in an external buffer (feed) are decoded in place from that buffer as well: only a frame split
+ * across two buffers is copied to the reader buffer.
+ * Only frames starting with a valid SYNC word and with a correct CHK are returned, otherwise the reader
+ * discards the bytes up to the next SYNC word.
+ */
+class FC37118FrameReader
+{
+public:
+    FC37118FrameReader();
+    ~FC37118FrameReader();
+
+    void reset();
+
+    unsigned char *write_ptr() { return m_buffer.data() + m_end; }
+    size_t write_space() { return m_buffer.size() - m_end; }
+    void commit(size_t size) { m_end += size; }
+
+    /**
+     * @brief decode the bytes of an external buffer, which must stay valid until next() returns false
+     * (size up to FRAME_READER_BUFFER_SIZE - C37118_MAX_FRAME_SIZE)
+     */
+    void feed(const unsigned char *data, size_t size);
+
+    /**
+     * @brief extract the next complete and valid frame
+     *
+     * @param frame set to the frame, valid until the next call
+     * @param size set to the frame size
+     * @return true - a frame is available
+     * @return false - more bytes are needed
+     */
+    bool next(unsigned char **frame, size_t *size);
+
+    unsigned long get_nb_crc_errors() { return m_nb_crc_errors; }
+    unsigned long get_nb_skipped_bytes() { return m_nb_skipped_bytes; }
+
+private:
+    std::vector<unsigned char> m_buffer;
+    size_t m_begin;
+    size_t m_end;
+    unsigned long m_nb_crc_errors;
+    unsigned long m_nb_skipped_bytes;
+
+    // external buffer given to feed(), decoded in place while the reader buffer is empty
+    const unsigned char *m_external;
+    size_t m_external_begin;
+    size_t m_external_end;
+
+    void m_skip(const unsigned char *data, size_t *begin, size_t end, size_t size);
+    bool m_parse(const unsigned char *data, size_t *begin, size_t end, unsigned char **frame, size_t *size);
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118INGESTQUEUE_H
+#define _F_C37118INGESTQUEUE_H
+
+#include <thread>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+
+#include "reading.h"
+#include "logger.h"
+#include "fc37118conf.h"
+
+// rough memory footprint of one Datapoint with its value and name
+#define DATAPOINT_SIZE_ESTIMATE 128
+
+/**
+ * @brief a reading with the IDCODE of the station it was built from
+ * (the IDCODE of the stream source for Multi_PMU readings),
+ * and the arrival time in ns of the frame it was built from, 0 when not known (readings held back by CHUNK or TRIGGER)
+ */
+struct FC37118Reading
+{
+    unsigned short idcode;
+    Reading *reading;
+    uint64_t arrival_ns;
+};
+
+/**
+ * @brief Bounded queue between the receiving thread and the ingest callback.
+ * The queue is bounded in number of readings and in memory; when it overflows the configured policy
+ * decides which readings are dropped. Drops are counted per IDCODE and reported every REPORT_PERIOD.
+ */
+class FC37118IngestQueue
+{
+public:
+    typedef std::function<void(const FC37118Reading &)> IngestFunction;
+
+    FC37118IngestQueue();
+    ~FC37118IngestQueue();
+
+    void start(FC37118QueueConf *conf, IngestFunction ingest);
+    void stop();
+    bool is_running() { return m_consumer != nullptr; }
+
+    /**
+     * @brief queue a reading, the queue takes the ownership of the reading
+     */
+    void push(const FC37118Reading &reading);
+
+private:
+    struct Entry
+    {
+        FC37118Reading reading;
+        size_t size;
+        bool is_priority;
+    };
+
+    FC37118QueueConf *m_conf;
+    IngestFunction m_ingest;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Entry> m_entries;
+    size_t m_memory;
+    bool m_stopping;
+    std::thread *m_consumer;
+
+    std::set<unsigned short> m_priority_idcodes;
+    std::map<unsigned short, unsigned long> m_nth_counters;
+    std::map<unsigned short, unsigned long> m_period_drops;
+    std::map<unsigned short, unsigned long> m_total_drops;
+    size_t m_period_max_depth;
+
+    bool m_is_full(size_t size);
+    bool m_is_overloaded();
+    bool m_make_room(const Entry &entry);
+    void m_drop(const Entry &entry);
+    void m_consume();
+    void m_report();
+};
+
+size_t estimate_reading_size(Reading *reading);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118LOADSHEDDING_H
+#define _F_C37118LOADSHEDDING_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+
+#define DP_LOAD_SHEDDING "LoadShedding"
+#define DP_SHED_LEVEL "Level"
+#define DP_SHED_PREVIOUS_LEVEL "PreviousLevel"
+#define DP_SHED_FRAME_TIME_US "FrameTimeUs"
+#define DP_SHED_BUDGET_US "BudgetUs"
+
+// the processing time is averaged over windows of this duration before being compared to the budget
+#define LOAD_SHEDDING_WINDOW_S 1
+
+/**
+ * @brief Adaptive load shedding.
+ * The processing time of each data frame (decode, conversion, and ingest unless queued) is compared to a budget,
+ * BUDGET_PERCENT of the frame period derived from DATA_RATE. When the average over each second exceeds the budget for
+ * OVERLOAD_S, the next LEVELS entry is applied (decimation, fewer channels, compact readings). When the processing time
+ * the previous level would take stays under RECOVERY_PERCENT of the budget for RECOVERY_S, it is restored. Each change is
+ * logged and ingested as an event.
+ * The processing time of the previous level is estimated from the frames converted at the current level, scaled by the
+ * ratio between the converted frames of both levels measured around the step up, and by the DECIMATION of the previous level.
+ */
+class FC37118LoadShedding
+{
+public:
+    FC37118LoadShedding();
+    ~FC37118LoadShedding();
+
+    void configure(FC37118LoadSheddingConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief output of the current level, the full output at level 0
+     */
+    const FC37118LoadLevelConf &get_level() { return m_level == 0 ? m_full_level : m_levels[m_level - 1]; }
+
+    /**
+     * @brief whether the readings of the current frame are output, according to the DECIMATION of the level
+     */
+    bool is_output_frame();
+
+    /**
+     * @brief account for the processing time of a data frame of config_frame
+     *
+     * @param is_output whether the readings of the frame were converted and output
+     * @return the event reading when the level changes, nullptr otherwise
+     */
+    Reading *frame_done(CONFIG_Frame *config_frame, unsigned long config_version, bool is_output, std::chrono::steady_clock::duration elapsed);
+
+private:
+    FC37118LoadSheddingConf *m_conf;
+    FC37118LoadLevelConf m_full_level;
+    std::vector<FC37118LoadLevelConf> m_levels;
+    size_t m_level;
+    unsigned long m_nb_frames;
+
+    unsigned long m_config_version;
+    double m_budget_us;
+
+    std::chrono::steady_clock::time_point m_window_end;
+    double m_window_us;
+    unsigned long m_window_frames;
+    double m_window_output_us;
+    unsigned long m_window_output_frames;
+    // per level: cost of a converted frame of the previous level / of this level, measured around the step up
+    std::vector<double> m_cost_ratios;
+    // cost of a converted frame at the level just left, until the cost at the new level is measured
+    double m_step_output_us;
+    uint m_overload_s;
+    uint m_recovery_s;
+
+    void m_reset_window();
+    double m_decimation(size_t level) { return level == 0 ? 1 : m_levels[level - 1].decimation; }
+    Reading *m_change_level(size_t level, unsigned short idcode, double frame_time_us);
+};
+
+#endif
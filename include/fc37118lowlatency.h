@@ -0,0 +1,63 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118LOWLATENCY_H
+#define _F_C37118LOWLATENCY_H
+
+#include <cstdint>
+#include <string>
+#include <set>
+#include <mutex>
+
+#include "logger.h"
+#include "fc37118conf.h"
+
+/**
+ * @brief Applies the LOW_LATENCY profile to the receiving thread and its socket, and reads from the socket
+ * with the kernel receive timestamp when enabled.
+ * A setting that cannot be applied (e.g. missing privileges) is logged once per configuration.
+ * Shared by the receiving threads of the paths.
+ */
+class FC37118LowLatency
+{
+public:
+    FC37118LowLatency();
+    ~FC37118LowLatency();
+
+    void configure(FC37118LowLatencyConf *conf);
+
+    /**
+     * @brief set cpu affinity and scheduling policy of the calling thread
+     */
+    void apply_thread();
+
+    /**
+     * @brief set the socket options, to be called before connect() so that the receive buffer size is taken into account for the TCP window
+     */
+    void apply_socket(int sockfd);
+
+    /**
+     * @brief read from the socket
+     *
+     * @param arrival_ns set to the kernel receive timestamp if enabled and available, to the current time otherwise
+     * @return the result of the read
+     */
+    int read(int sockfd, unsigned char *buffer, size_t size, uint64_t *arrival_ns);
+
+private:
+    FC37118LowLatencyConf *m_conf;
+    std::set<std::string> m_failed_settings;
+    std::mutex m_failed_settings_mutex;
+    bool m_kernel_timestamps;
+
+    bool m_check(bool is_ok, const std::string &setting);
+};
+
+#endif
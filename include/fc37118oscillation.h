@@ -0,0 +1,96 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118OSCILLATION_H
+#define _F_C37118OSCILLATION_H
+
+#include <complex>
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+#include "fc37118channel.h"
+
+#define DP_OSCILLATION "Oscillation"
+#define DP_MODES "Modes"
+#define DP_MODE "Mode"
+#define DP_MODE_FREQUENCY "Frequency"
+#define DP_MODE_DAMPING "DampingRatio"
+#define DP_MODE_AMPLITUDE "Amplitude"
+
+/**
+ * @brief Streaming low frequency oscillation detector.
+ * Each configured channel is decimated to SAMPLE_RATE and feeds a sliding DFT restricted to the [MIN_FREQ, MAX_FREQ] bins
+ * of a WINDOW_S window, so memory and cpu per channel are bounded by the window length and the number of bins.
+ * Every EMIT_PERIOD_S the dominant mode of each channel is estimated from the Hann windowed spectrum:
+ * frequency by interpolation around the peak bin, amplitude from the peak magnitude,
+ * and damping from the decay of the peak amplitude between two estimations.
+ */
+class FC37118Oscillation
+{
+public:
+    FC37118Oscillation();
+    ~FC37118Oscillation();
+
+    void configure(FC37118OscillationConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief feed the data frame last unpacked with config_frame
+     *
+     * @return Reading* - the mode reading when an emission is due, nullptr otherwise
+     */
+    Reading *update(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time);
+
+private:
+    struct Channel
+    {
+        FC37118OscillationChannelConf conf;
+        FC37118ChannelRef ref;
+        std::string label;
+
+        double accumulator;
+        uint nb_accumulated;
+        double previous_raw;
+        double unwrap_offset;
+
+        std::vector<double> samples;
+        size_t position;
+        size_t nb_samples;
+        size_t since_refresh;
+        std::vector<std::complex<double>> bins;
+
+        bool has_previous_mode;
+        int previous_bin;
+        double previous_amplitude;
+        double previous_time;
+    };
+
+    FC37118OscillationConf *m_conf;
+    unsigned long m_config_version;
+    std::vector<Channel> m_channels;
+    uint m_decimation;
+    double m_sample_rate;
+    size_t m_window;
+    int m_first_bin;
+    int m_last_bin;
+    std::vector<std::complex<double>> m_twiddles;
+    double m_next_emit;
+    unsigned short m_stream_idcode;
+
+    void m_setup(CONFIG_Frame *config_frame);
+    void m_push_sample(Channel &channel, double sample);
+    void m_refresh(Channel &channel);
+    Datapoint *m_estimate_mode(Channel &channel, double time);
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118PATH_H
+#define _F_C37118PATH_H
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "fc37118tls.h"
+#include "fc37118framereader.h"
+#include "fc37118uring.h"
+
+/**
+ * @brief A connection to a stream source, received by its own thread: socket, TLS session, io_uring receive, frame reassembly and discarded frame counters
+ */
+struct FC37118Path
+{
+    FC37118Path(size_t path_index, const std::string &ip_addr, uint port, FC37118TlsConf *tls_conf, FC37118UringConf *uring_conf) : index(path_index),
+                                                                                                                                    name(ip_addr + ":" + std::to_string(port)),
+                                                                                                                                    sockfd(0),
+                                                                                                                                    arrival_ns(0),
+                                                                                                                                    thread(nullptr),
+                                                                                                                                    nb_size_errors(0),
+                                                                                                                                    nb_consecutive_size_errors(0),
+                                                                                                                                    reported_frame_errors(0)
+    {
+        memset(&serv_addr, 0, sizeof(serv_addr));
+        serv_addr.sin_family = AF_INET;
+        serv_addr.sin_addr.s_addr = inet_addr(ip_addr.c_str());
+        serv_addr.sin_port = htons(port);
+        tls.configure(tls_conf);
+        uring.configure(uring_conf);
+    }
+
+    size_t index;
+    std::string name;
+    struct sockaddr_in serv_addr;
+    int sockfd;
+    FC37118Tls tls;
+    FC37118Uring uring;
+    FC37118FrameReader frame_reader;
+    uint64_t arrival_ns;
+    std::thread *thread;
+
+    unsigned long nb_size_errors;
+    unsigned long nb_consecutive_size_errors;
+    unsigned long reported_frame_errors;
+    std::chrono::steady_clock::time_point last_frame_error_report;
+};
+
+#endif
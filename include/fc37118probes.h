@@ -0,0 +1,47 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118PROBES_H
+#define _F_C37118PROBES_H
+
+/**
+ * @brief USDT static probes of the provider fc37118, on the stage boundaries of the frame processing
+ * (see tools/trace/fc37118_latency.bt):
+ *   read(path, bytes)                      bytes read from the connection of a path
+ *   frame(path, type, size)                frame reassembled and validated
+ *   unpack_start(size), unpack_done(soc, fracsec)
+ *   convert_start(soc, fracsec), convert_done(soc, fracsec, readings)
+ *   station_start(idcode), station_done(idcode)
+ *   ingest_start(asset), ingest_done(asset)
+ *   frame_done(soc, fracsec)               data frame fully processed
+ * A probe is a single nop while no tracer is attached. Without <sys/sdt.h> (systemtap-sdt-dev) at build time
+ * the probes compile to nothing and their arguments are not evaluated.
+ */
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define FC37118_PROBE1(name, arg1) DTRACE_PROBE1(fc37118, name, arg1)
+#define FC37118_PROBE2(name, arg1, arg2) DTRACE_PROBE2(fc37118, name, arg1, arg2)
+#define FC37118_PROBE3(name, arg1, arg2, arg3) DTRACE_PROBE3(fc37118, name, arg1, arg2, arg3)
+#else
+#define FC37118_PROBE1(name, arg1) \
+    do                             \
+    {                              \
+    } while (0)
+#define FC37118_PROBE2(name, arg1, arg2) \
+    do                                   \
+    {                                    \
+    } while (0)
+#define FC37118_PROBE3(name, arg1, arg2, arg3) \
+    do                                         \
+    {                                          \
+    } while (0)
+#endif
+
+#endif
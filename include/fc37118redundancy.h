@@ -0,0 +1,100 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118REDUNDANCY_H
+#define _F_C37118REDUNDANCY_H
+
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "logger.h"
+#include "fc37118conf.h"
+
+/**
+ * @brief Deduplication of the data frames received on redundant paths: the first copy of a frame, identified by (IDCODE, SOC, FRACSEC),
+ * is processed, the copies received later on the other paths are dropped.
+ * The arrival lead of each path over the others is measured and reported every REPORT_PERIOD.
+ * Not thread safe: calls shall be serialised by the caller.
+ */
+class FC37118Redundancy
+{
+public:
+    FC37118Redundancy();
+    ~FC37118Redundancy();
+
+    void configure(FC37118RedundancyConf *conf, const std::vector<std::string> &path_names);
+    bool is_enabled() { return m_paths.size() > 1; }
+
+    /**
+     * @brief record the arrival of a data frame on a path
+     *
+     * @return true - first copy of the frame, to be processed
+     * @return false - copy of a frame already received on another path, or older than the deduplication window
+     */
+    bool first_arrival(size_t path, const unsigned char *frame, uint64_t arrival_ns);
+
+    /**
+     * @brief TIME_BASE of the current configuration, so that the frame times are linear for the late threshold
+     */
+    void set_time_base(uint32_t time_base);
+
+private:
+    struct Entry
+    {
+        uint16_t idcode;
+        uint32_t soc;
+        uint32_t fracsec;
+        uint64_t first_arrival_ns;
+        size_t first_path;
+        uint32_t paths_mask;
+    };
+
+    /**
+     * @brief frame times of an IDCODE: last frame accepted, and newest frame evicted from the window, which is the late threshold
+     */
+    struct Timeline
+    {
+        uint64_t last_time;
+        uint64_t evicted_time;
+    };
+
+    struct PathStats
+    {
+        std::string name;
+        unsigned long nb_frames;
+        unsigned long nb_first;
+        unsigned long nb_only;
+        unsigned long nb_leads;
+        double lead_sum_ns;
+        uint64_t lead_max_ns;
+    };
+
+    std::vector<Entry> m_window;
+    size_t m_next_slot;
+    size_t m_nb_entries;
+    std::unordered_map<uint64_t, size_t> m_index;
+    std::unordered_map<uint16_t, Timeline> m_timelines;
+    uint32_t m_time_base;
+    unsigned long m_nb_late;
+    unsigned long m_nb_resets;
+
+    std::vector<PathStats> m_paths;
+    std::chrono::seconds m_report_period;
+    std::chrono::steady_clock::time_point m_last_report;
+
+    uint64_t m_frame_time(uint32_t soc, uint32_t fracsec) { return (uint64_t)soc * m_time_base + (fracsec & 0x00FFFFFF); }
+    void m_evict(size_t slot);
+    void m_report();
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118SERVER_H
+#define _F_C37118SERVER_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "fc37118conf.h"
+#include "fc37118framereader.h"
+
+#define SERVER_DEFAULT_HEADER "fledge-south-c37118 re-publisher"
+
+/**
+ * @brief C37.118 server re-publishing the stream to downstream clients, so that they do not open their own connection to the PMU.
+ * HDR and CFG-1/CFG-2 commands are answered from the held header and configuration frame, TURNON/TURNOFF start and stop
+ * the data frames of the client.
+ * Data frames are sent straight from the receive buffer, without blocking. Only the bytes a client cannot take at once
+ * are copied, once for all the clients, in the bounded send queue of the client: a slow client never stalls the ingest,
+ * its new frames are dropped while its queue is full.
+ */
+class FC37118Server
+{
+public:
+    FC37118Server();
+    ~FC37118Server();
+
+    void configure(FC37118ServerConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief listen and start the thread serving the clients
+     */
+    bool start();
+    void stop();
+    bool is_running() { return m_thread != nullptr; }
+
+    /**
+     * @brief header information sent in the HDR frames
+     */
+    void set_header(const std::string &header);
+
+    /**
+     * @brief configuration frame sent to the clients, with the frame type they request
+     */
+    void set_config_frame(const unsigned char *frame, size_t size);
+
+    /**
+     * @brief send a data frame to the clients that turned the transmission on
+     */
+    void forward(const unsigned char *frame, size_t size);
+
+private:
+    struct Pending
+    {
+        std::shared_ptr<std::vector<unsigned char>> frame;
+        size_t offset;
+    };
+
+    struct Client
+    {
+        int fd;
+        std::string name;
+        FC37118FrameReader reader;
+        bool is_sending;
+        bool is_broken;
+        bool is_dropping;
+        std::deque<Pending> queue;
+        unsigned long nb_sent;
+        unsigned long nb_dropped;
+    };
+
+    FC37118ServerConf *m_conf;
+    int m_listen_fd;
+    int m_wake_fd;
+    std::thread *m_thread;
+    std::atomic<bool> m_is_running;
+
+    std::mutex m_mutex; // clients, queues, header and configuration frame
+    std::vector<Client *> m_clients;
+    std::string m_header;
+    std::vector<unsigned char> m_config_frame;
+
+    void m_run();
+    void m_wake();
+    void m_accept();
+    bool m_receive(Client *client);
+    void m_command(Client *client, const unsigned char *frame);
+    void m_send(Client *client, const unsigned char *data, size_t size, std::shared_ptr<std::vector<unsigned char>> &copy, bool can_drop);
+    void m_flush(Client *client);
+    void m_close(Client *client);
+    std::vector<unsigned char> m_header_frame();
+};
+
+#endif
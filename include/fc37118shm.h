@@ -0,0 +1,69 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118SHM_H
+#define _F_C37118SHM_H
+
+#include <vector>
+
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+#include "fc37118shmlayout.h"
+
+/**
+ * @brief Publishes each decoded data frame in a POSIX shared memory ring for co-located consumers (see fc37118shmlayout.h).
+ * The channel table is rebuilt when the c37.118 configuration changes. If the configuration has more than MAX_CHANNELS channels,
+ * nothing is published until it changes.
+ */
+class FC37118ShmPublisher
+{
+public:
+    FC37118ShmPublisher();
+    ~FC37118ShmPublisher();
+
+    void configure(FC37118ShmConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief create and map the shared memory segment
+     */
+    bool open();
+
+    /**
+     * @brief mark the segment closed for the readers and remove it
+     */
+    void close();
+    bool is_open() { return m_header != nullptr; }
+
+    /**
+     * @brief publish the data frame last unpacked with config_frame
+     */
+    void publish(CONFIG_Frame *config_frame, unsigned long config_version, const std::vector<uint> &filter,
+                 uint32_t soc, uint32_t fracsec, double frame_time);
+
+private:
+    FC37118ShmConf *m_conf;
+    int m_fd;
+    void *m_map;
+    size_t m_map_size;
+    FC37118ShmHeader *m_header;
+    FC37118ShmChannel *m_channels;
+    unsigned char *m_slots;
+
+    unsigned long m_config_version;
+    std::vector<size_t> m_stations;
+    uint32_t m_nb_channels;
+    bool m_fits;
+
+    void m_describe(CONFIG_Frame *config_frame, unsigned long config_version, const std::vector<uint> &filter);
+};
+
+#endif
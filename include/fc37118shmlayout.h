@@ -0,0 +1,87 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118SHMLAYOUT_H
+#define _F_C37118SHMLAYOUT_H
+
+/*
+ * Binary layout of the shared memory segment published by the plugin (SHM section), shared with the reader library.
+ * No dependency on Fledge nor Open-C37.118.
+ *
+ * | FC37118ShmHeader | FC37118ShmChannel[max_channels] | slot[slot_count] |
+ * slot: | FC37118ShmSlotHeader | float values[max_channels] |, slot_size bytes
+ *
+ * Single writer, any number of readers mapping the segment read only. Each slot and the channel table are protected by a
+ * sequence number (seqlock): odd while being written. A reader copies the data, then checks that the sequence number is even
+ * and has not changed, otherwise retries: readers never block the writer.
+ */
+
+#include <atomic>
+#include <cstdint>
+
+#define SHM_MAGIC "C37SHM01"
+#define SHM_LAYOUT_VERSION 1
+#define SHM_NAME_SIZE 16
+#define SHM_ALIGN 64
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "64 bits atomics shall be lock free to be shared between processes");
+
+enum FC37118ShmChannelKind : uint8_t
+{
+    SHM_CHANNEL_STAT = 0,
+    SHM_CHANNEL_FREQ = 1,  // Hz
+    SHM_CHANNEL_DFREQ = 2, // Hz/s
+    SHM_CHANNEL_PHASOR_MAGNITUDE = 3,
+    SHM_CHANNEL_PHASOR_ANGLE = 4, // rad
+    SHM_CHANNEL_ANALOG = 5
+};
+
+struct FC37118ShmHeader
+{
+    char magic[8];
+    uint32_t layout_version;
+    uint32_t writer_pid;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t max_channels;
+    uint32_t reserved;
+    uint64_t channels_offset;
+    uint64_t slots_offset;
+
+    std::atomic<uint32_t> is_closed;  // set when the writer stops
+    std::atomic<uint64_t> write_count; // number of frames published, the last one is in slot (write_count - 1) % slot_count
+    std::atomic<uint64_t> channels_seq; // seqlock of the channel table and of the fields below
+    uint64_t config_version;          // changes with the c37.118 configuration
+    uint32_t nb_channels;
+    uint32_t nb_stations;
+};
+
+struct FC37118ShmChannel
+{
+    uint16_t idcode;
+    uint16_t station_index;
+    uint8_t kind; // FC37118ShmChannelKind
+    uint8_t reserved[3];
+    char station_name[SHM_NAME_SIZE]; // STN, not null terminated if SHM_NAME_SIZE long
+    char name[SHM_NAME_SIZE];         // CHNAM of phasors and analogs, not null terminated if SHM_NAME_SIZE long
+};
+
+struct alignas(SHM_ALIGN) FC37118ShmSlotHeader
+{
+    std::atomic<uint64_t> seq;
+    uint64_t frame_count; // 1 for the first frame published
+    uint64_t config_version;
+    uint32_t soc;
+    uint32_t fracsec;
+    double frame_time; // SOC + FRACSEC / TIME_BASE
+    uint32_t nb_channels;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118SOAK_H
+#define _F_C37118SOAK_H
+
+#include <cstdint>
+#include <chrono>
+
+#include "logger.h"
+#include "fc37118conf.h"
+
+/**
+ * @brief resident set size of the process in kB, -1 if unavailable
+ */
+long get_rss_kb();
+
+/**
+ * @brief Memory monitoring of the running service: every SAMPLE_PERIOD_S the RSS is logged.
+ * The RSS at the end of the warmup is the baseline: a growth over MAX_GROWTH_KB is logged as an error,
+ * and the verdict is logged when the plugin stops. The soak test itself is tools/soak.
+ */
+class FC37118Soak
+{
+public:
+    FC37118Soak();
+    ~FC37118Soak();
+
+    void configure(FC37118SoakConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    void start();
+
+    /**
+     * @brief to be called for each processed data frame
+     */
+    void frame()
+    {
+        if ((++m_nb_frames & 0x1F) == 0 && std::chrono::steady_clock::now() >= m_next_sample)
+            m_sample();
+    }
+
+    void stop();
+
+private:
+    FC37118SoakConf *m_conf;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_next_sample;
+    uint64_t m_nb_frames;
+    long m_baseline_rss_kb;
+    long m_max_growth_kb;
+    bool m_is_failed;
+
+    void m_sample();
+};
+
+#endif
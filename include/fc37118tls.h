@@ -0,0 +1,69 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118TLS_H
+#define _F_C37118TLS_H
+
+#include <cstddef>
+#include <string>
+
+#include "logger.h"
+#include "fc37118conf.h"
+
+struct ssl_st;
+struct ssl_ctx_st;
+
+/**
+ * @brief TLS client session on the PMU connection (requires the plugin to be built with OpenSSL).
+ * Once the handshake is done, the session keys are handed to the kernel (kTLS) when KTLS is set and the kernel supports it:
+ * the socket can then be read directly, records being decrypted by the kernel. Otherwise records are decrypted in user space by read().
+ */
+class FC37118Tls
+{
+public:
+    FC37118Tls();
+    ~FC37118Tls();
+
+    void configure(FC37118TlsConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+
+    /**
+     * @brief true if the records of the current session are decrypted by the kernel
+     */
+    bool is_kernel_rx() { return m_kernel_rx; }
+
+    /**
+     * @brief TLS handshake on a connected socket, authenticating the PMU with the CA and/or the pinned fingerprints
+     *
+     * @param peer_address IP address of the PMU, checked against the certificate when CA_FILE is set without SERVER_NAME
+     * @return true - the session is established
+     * @return false - the handshake or the authentication failed
+     */
+    bool handshake(int sockfd, const std::string &peer_address);
+
+    int read(unsigned char *buffer, size_t size);
+    int write(const unsigned char *buffer, size_t size);
+
+    /**
+     * @brief release the session. No close_notify is sent, the socket may already be closed
+     */
+    void close();
+
+private:
+    FC37118TlsConf *m_conf;
+    ssl_ctx_st *m_ctx;
+    ssl_st *m_ssl;
+    bool m_kernel_rx;
+
+    bool m_init_context();
+    bool m_check_pinning();
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118TRIGGER_H
+#define _F_C37118TRIGGER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+#include "fc37118ingestqueue.h"
+
+#define DP_TRIGGER "Trigger"
+#define TRG_RULE_STAT "STAT"
+
+// time constant of the voltage magnitude baseline used by the sag rule
+#define TRG_BASELINE_TAU_S 10.0
+
+/**
+ * @brief Event triggered output.
+ * Outside of events, the readings are output at OUTPUT_RATE, aligned on SOC. All readings go through a preallocated
+ * circular pre-trigger buffer of PRE_FRAMES per output (station, or stream source for Multi_PMU readings): the OUTPUT_RATE
+ * ones are output when they leave the buffer, the others are dropped. When a rule fires, the pre-trigger buffer is
+ * flushed and the next POST_FRAMES readings are output at full rate. The output is thus always in time order.
+ */
+class FC37118Trigger
+{
+public:
+    FC37118Trigger();
+    ~FC37118Trigger();
+
+    void configure(FC37118TriggerConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+    void clear();
+
+    /**
+     * @brief output the OUTPUT_RATE readings still held in the pre-trigger buffers, delete the others
+     */
+    void flush(std::vector<FC37118Reading> &output);
+
+    /**
+     * @brief evaluate the rules on the data frame last unpacked with config_frame
+     */
+    void evaluate(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time);
+
+    /**
+     * @brief select the readings to output, takes the ownership of reading
+     *
+     * @param output readings to ingest, in order
+     */
+    void filter(const FC37118Reading &reading, double frame_time, std::vector<FC37118Reading> &output);
+
+private:
+    struct StationState
+    {
+        unsigned short idcode;
+        std::vector<int> voltage_channels;
+        std::vector<double> baselines;
+        std::vector<double> previous_angles;
+        bool has_previous;
+    };
+
+    struct HeldReading
+    {
+        FC37118Reading reading;
+        bool is_output; // OUTPUT_RATE reading, output when it leaves the buffer
+    };
+
+    struct OutputState
+    {
+        std::vector<HeldReading> ring;
+        size_t head;
+        size_t count;
+        uint post_remaining;
+        long last_slot;
+    };
+
+    FC37118TriggerConf *m_conf;
+    unsigned long m_config_version;
+    unsigned short m_stream_idcode;
+    double m_previous_time;
+    std::vector<StationState> m_stations;
+    std::map<unsigned short, OutputState> m_outputs;
+    std::map<unsigned short, std::string> m_fired_rules;
+
+    void m_setup(CONFIG_Frame *config_frame);
+    std::string m_evaluate_station(PMU_Station *pmu_station, StationState &state, double dt);
+    void m_flush(OutputState &state, std::vector<FC37118Reading> &output, bool is_all);
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118URING_H
+#define _F_C37118URING_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "logger.h"
+#include "fc37118conf.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+/**
+ * @brief io_uring receive backend of a connection (raw syscalls, no liburing dependency): one multishot receive
+ * fills the buffers of a registered provided buffer ring, and the received bytes are decoded in place from these buffers.
+ * A buffer is given back to the kernel once its frames are processed (release()).
+ * Requires Linux 6.0 (multishot receive, provided buffer rings): open() fails on older kernels and the caller
+ * keeps the read() path.
+ */
+class FC37118Uring
+{
+public:
+    FC37118Uring();
+    ~FC37118Uring();
+
+    void configure(FC37118UringConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+    bool is_open() { return m_ring_fd >= 0; }
+
+    /**
+     * @brief set up the ring for a connected socket and arm the multishot receive
+     *
+     * @return false - io_uring is not available, the read() path shall be used
+     */
+    bool open(int sockfd);
+    void close();
+
+    /**
+     * @brief wait for received bytes
+     *
+     * @param data set to the buffer filled by the kernel, valid until release()
+     * @return the number of bytes, 0 if the connection is closed, -1 on error (errno set). If the kernel does not support
+     * the multishot receive, the ring is closed and -1 returned with errno set to EOPNOTSUPP: the read() path shall be used
+     */
+    int receive(unsigned char **data);
+
+    /**
+     * @brief give back to the kernel the buffer returned by the last receive()
+     */
+    void release();
+
+private:
+    FC37118UringConf *m_conf;
+    int m_ring_fd;
+    int m_sockfd;
+
+    void *m_sq_ring;
+    size_t m_sq_ring_size;
+    void *m_cq_ring;
+    size_t m_cq_ring_size;
+    io_uring_sqe *m_sqes;
+    size_t m_sqes_size;
+    unsigned *m_sq_tail;
+    unsigned *m_sq_mask;
+    unsigned *m_sq_array;
+    unsigned *m_cq_head;
+    unsigned *m_cq_tail;
+    unsigned *m_cq_mask;
+    io_uring_cqe *m_cqes;
+
+    io_uring_buf_ring *m_buf_ring;
+    unsigned char *m_buffers;
+    uint16_t m_buf_tail;
+    int m_pending_buffer;
+    bool m_is_armed;
+    unsigned long m_nb_completions;
+
+    void m_provide(uint16_t buffer_id);
+    bool m_arm();
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118VALIDATION_H
+#define _F_C37118VALIDATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "reading.h"
+#include "logger.h"
+#include "c37118configuration.h"
+#include "fc37118conf.h"
+
+#define DP_BAD_DATA "BadData"
+#define DP_BAD_CHANNEL "Channel"
+#define DP_BAD_REASON "Reason"
+
+// reasons of invalidity, as bits of the channel flags
+#define BAD_NAN 0x01
+#define BAD_RANGE 0x02
+#define BAD_FROZEN 0x04
+#define BAD_STEP 0x08
+#define BAD_STAT 0x10
+#define BAD_NB_REASONS 5
+
+// channels with bad data listed in each report, the others are only counted
+#define VALIDATION_REPORT_MAX_CHANNELS 20
+
+/**
+ * @brief Streaming validation of the decoded values.
+ * The channels of all stations (FREQ, DFREQ, magnitude and angle of each phasor, each analog) are laid out in flat arrays
+ * when the configuration changes. Each frame, the values are gathered then checked in one pass per check: not a number,
+ * range, frozen over FROZEN_FRAMES, step between two frames, STAT quality bits. The cost per frame only depends on the
+ * number of channels. The flags of the last frame tell the readings which values to annotate or leave out.
+ * Bad values are counted per channel and reason, and reported every REPORT_PERIOD.
+ */
+class FC37118Validation
+{
+public:
+    FC37118Validation();
+    ~FC37118Validation();
+
+    void configure(FC37118ValidationConf *conf);
+    bool is_enabled() { return m_conf != nullptr && m_conf->is_enabled(); }
+    bool is_suppress() { return m_conf->is_suppress(); }
+
+    /**
+     * @brief check the data frame last unpacked with config_frame
+     */
+    void evaluate(CONFIG_Frame *config_frame, unsigned long config_version, double frame_time);
+
+    /**
+     * @brief flags of the last frame for the station at index in the configuration, BAD_* bits for:
+     * FREQ, DFREQ, then the magnitude and the angle of each phasor, then each analog
+     */
+    const uint8_t *get_flags(size_t station) { return m_flags.data() + m_offsets[station]; }
+    bool is_bad(size_t station) { return m_bad_stations[station] != 0; }
+
+    /**
+     * @brief BadData datapoint listing the invalid channels of the station with their reasons, nullptr if none
+     */
+    Datapoint *to_datapoint(size_t station);
+
+    /**
+     * @brief reasons of the BAD_* flags, e.g. "RANGE|STEP"
+     */
+    static std::string to_reasons(uint8_t flags);
+
+private:
+    enum ChannelKind : uint8_t
+    {
+        FREQ,
+        DFREQ,
+        VOLTAGE,
+        CURRENT,
+        ANGLE,
+        ANALOG
+    };
+
+    FC37118ValidationConf *m_conf;
+    unsigned long m_config_version;
+    double m_previous_time;
+
+    // per station
+    std::vector<size_t> m_offsets; // first channel, one more entry for the end
+    std::vector<unsigned short> m_idcodes;
+    std::vector<double> m_fnoms;
+    std::vector<uint8_t> m_bad_stations;
+
+    // per channel
+    std::vector<std::string> m_labels;
+    std::vector<uint8_t> m_kinds;
+    std::vector<size_t> m_stations;
+    std::vector<double> m_mins;
+    std::vector<double> m_maxs;
+    std::vector<double> m_values;
+    std::vector<double> m_previous_values;
+    std::vector<uint> m_frozen_counts;
+    std::vector<uint8_t> m_flags;
+    std::vector<unsigned long> m_counts; // BAD_NB_REASONS per channel, over the report period
+    std::vector<unsigned long> m_total_counts;
+    bool m_has_previous;
+
+    std::chrono::steady_clock::time_point m_next_report;
+
+    void m_setup(CONFIG_Frame *config_frame);
+    void m_gather(CONFIG_Frame *config_frame);
+    void m_report();
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118WORKERPOOL_H
+#define _F_C37118WORKERPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+#include "logger.h"
+
+/**
+ * @brief Fixed pool of worker threads sharing out a range of indexes.
+ * run() splits [0, count) in contiguous shards, one per worker plus one for the calling thread,
+ * and returns once every shard is processed.
+ */
+class FC37118WorkerPool
+{
+public:
+    typedef std::function<void(size_t begin, size_t end)> Task;
+
+    FC37118WorkerPool();
+    ~FC37118WorkerPool();
+
+    /**
+     * @brief start the workers
+     *
+     * @param nb_workers number of worker threads, the calling thread comes in addition
+     * @param cpus cpus the workers are pinned to (round robin), not pinned if empty
+     */
+    void start(uint nb_workers, const std::vector<uint> &cpus);
+    void stop();
+    bool is_running() { return !m_workers.empty(); }
+
+    void run(size_t count, const Task &task);
+
+private:
+    std::vector<std::thread *> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_start_cv;
+    std::condition_variable m_done_cv;
+    bool m_stopping;
+    unsigned long m_generation;
+    size_t m_pending;
+    size_t m_count;
+    const Task *m_task;
+
+    void m_work(size_t shard);
+    void m_run_shard(size_t shard);
+};
+
+bool pin_thread(std::thread::native_handle_type thread, const std::vector<uint> &cpus);
+
+#endif
@@ -18,6 +18,7 @@
 bool retrieve(rapidjson::Value *doc, const char *key, bool *target);
 bool retrieve(rapidjson::Value *doc, const char *key, uint *target);
 bool retrieve(rapidjson::Value *doc, const char *key, int *target);
+bool retrieve(rapidjson::Value *doc, const char *key, double *target);
 bool retrieve(rapidjson::Value *doc, const char *key, std::string *target);
 bool retrieve(rapidjson::Value *doc, const char *key, std::vector<std::string> *target);
 bool retrieve(rapidjson::Value *doc, const char *key, std::vector<int> *target);
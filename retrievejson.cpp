@@ -40,6 +40,16 @@ bool retrieve(rapidjson::Value *value, const char *key, int *target)
     return true;
 }
 
+bool retrieve(rapidjson::Value *value, const char *key, double *target)
+{
+    if (!value->HasMember(key) || !(*value)[key].IsNumber())
+    {
+        return false;
+    }
+    *target = (*value)[key].GetDouble();
+    return true;
+}
+
 bool retrieve(rapidjson::Value *value, const char *key, std::string *target)
 {
     if (!value->HasMember(key) || !(*value)[key].IsString())
@@ -0,0 +1,224 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+/*
+ * Extracts the frames of the archive whose SOC is within [from, to] into a capture file, replayable with REPLAY.
+ * The segment holding <from> is found by its name, then the block by the index of the segment: only the blocks
+ * overlapping the range are read. Each segment contributes its configuration frame before its data frames.
+ *
+ * usage: c37118-archive-extract <archive directory> <from SOC> <to SOC> <capture file>
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "fc37118archivelayout.h"
+
+// see fc37118capture.h
+#define CAPTURE_MAGIC "C37CAP01"
+#define CAPTURE_MAGIC_SIZE 8
+
+#define FRAME_TYPE(frame) (((frame)[1] >> 4) & 0x07)
+
+struct Segment
+{
+    uint32_t first_soc;
+    std::string path;
+};
+
+static std::vector<Segment> list_segments(const std::string &directory)
+{
+    std::vector<Segment> segments;
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        return segments;
+    size_t prefix_size = strlen(ARCHIVE_FILE_PREFIX), suffix_size = strlen(ARCHIVE_SEGMENT_SUFFIX);
+    while (struct dirent *entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name.size() <= prefix_size + suffix_size || name.compare(0, prefix_size, ARCHIVE_FILE_PREFIX) != 0 ||
+            name.compare(name.size() - suffix_size, suffix_size, ARCHIVE_SEGMENT_SUFFIX) != 0)
+            continue;
+        segments.push_back(Segment{(uint32_t)strtoul(name.c_str() + prefix_size, nullptr, 10), directory + "/" + name});
+    }
+    closedir(dir);
+    std::sort(segments.begin(), segments.end(), [](const Segment &a, const Segment &b)
+              { return a.first_soc != b.first_soc ? a.first_soc < b.first_soc : a.path < b.path; });
+    return segments;
+}
+
+/**
+ * @brief the index of a segment, rebuilt from the block headers when the index file is missing or truncated
+ */
+static std::vector<FC37118ArchiveIndexEntry> load_index(const std::string &segment_path, FILE *segment)
+{
+    std::vector<FC37118ArchiveIndexEntry> index;
+    std::string index_path = segment_path.substr(0, segment_path.size() - strlen(ARCHIVE_SEGMENT_SUFFIX)) + ARCHIVE_INDEX_SUFFIX;
+    FILE *file = fopen(index_path.c_str(), "rb");
+    char magic[ARCHIVE_MAGIC_SIZE];
+    if (file != nullptr)
+    {
+        FC37118ArchiveIndexEntry entry;
+        if (fread(magic, 1, ARCHIVE_MAGIC_SIZE, file) == ARCHIVE_MAGIC_SIZE && memcmp(magic, ARCHIVE_INDEX_MAGIC, ARCHIVE_MAGIC_SIZE) == 0)
+            while (fread(&entry, sizeof(entry), 1, file) == 1)
+                index.push_back(entry);
+        fclose(file);
+        if (!index.empty())
+            return index;
+    }
+    fprintf(stderr, "%s: no index, scanning the blocks\n", segment_path.c_str());
+    FC37118ArchiveBlockHeader header;
+    uint64_t offset = ARCHIVE_MAGIC_SIZE;
+    while (fseek(segment, offset, SEEK_SET) == 0 && fread(&header, sizeof(header), 1, segment) == 1)
+    {
+        index.push_back(FC37118ArchiveIndexEntry{header.first_soc, header.last_soc, offset});
+        offset += sizeof(header) + header.stored_size;
+    }
+    return index;
+}
+
+/**
+ * @brief read and decompress the block at offset
+ */
+static bool read_block(FILE *segment, uint64_t offset, std::vector<unsigned char> &stored, std::vector<unsigned char> &block)
+{
+    FC37118ArchiveBlockHeader header;
+    if (fseek(segment, offset, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, segment) != 1 ||
+        header.stored_size > ARCHIVE_MAX_BLOCK_SIZE || header.raw_size > ARCHIVE_MAX_BLOCK_SIZE)
+        return false;
+    stored.resize(header.stored_size);
+    if (fread(stored.data(), 1, header.stored_size, segment) != header.stored_size)
+        return false;
+    if (header.compression == ARCHIVE_COMPRESSION_NONE)
+    {
+        block.swap(stored);
+        return true;
+    }
+#ifdef HAVE_ZLIB
+    if (header.compression == ARCHIVE_COMPRESSION_ZLIB)
+    {
+        uLongf raw_size = header.raw_size;
+        block.resize(raw_size);
+        return uncompress(block.data(), &raw_size, stored.data(), stored.size()) == Z_OK && raw_size == header.raw_size;
+    }
+#endif
+    fprintf(stderr, "unsupported block compression %u\n", header.compression);
+    return false;
+}
+
+static bool write_record(FILE *output, const unsigned char *record, uint32_t size)
+{
+    return fwrite(record, 1, ARCHIVE_RECORD_HEADER_SIZE + size, output) == ARCHIVE_RECORD_HEADER_SIZE + size;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 5)
+    {
+        fprintf(stderr, "usage: %s <archive directory> <from SOC> <to SOC> <capture file>\n", argv[0]);
+        return 1;
+    }
+    uint32_t from = strtoul(argv[2], nullptr, 10), to = strtoul(argv[3], nullptr, 10);
+    std::vector<Segment> segments = list_segments(argv[1]);
+    FILE *output = fopen(argv[4], "wb");
+    if (output == nullptr || fwrite(CAPTURE_MAGIC, 1, CAPTURE_MAGIC_SIZE, output) != CAPTURE_MAGIC_SIZE)
+    {
+        fprintf(stderr, "unable to write %s\n", argv[4]);
+        return 1;
+    }
+
+    // the last segment starting at or before <from> may hold its beginning
+    auto first = std::upper_bound(segments.begin(), segments.end(), from, [](uint32_t soc, const Segment &segment)
+                                  { return soc < segment.first_soc; });
+    if (first != segments.begin())
+        first--;
+
+    std::vector<unsigned char> stored, block, config;
+    unsigned long nb_frames = 0, nb_blocks = 0;
+    for (auto segment = first; segment != segments.end() && segment->first_soc <= to; segment++)
+    {
+        FILE *file = fopen(segment->path.c_str(), "rb");
+        char magic[ARCHIVE_MAGIC_SIZE];
+        if (file == nullptr || fread(magic, 1, ARCHIVE_MAGIC_SIZE, file) != ARCHIVE_MAGIC_SIZE ||
+            memcmp(magic, ARCHIVE_SEGMENT_MAGIC, ARCHIVE_MAGIC_SIZE) != 0)
+        {
+            fprintf(stderr, "%s is not an archive segment, skipped\n", segment->path.c_str());
+            if (file != nullptr)
+                fclose(file);
+            continue;
+        }
+        std::vector<FC37118ArchiveIndexEntry> index = load_index(segment->path, file);
+        auto entry = std::lower_bound(index.begin(), index.end(), from, [](const FC37118ArchiveIndexEntry &entry, uint32_t soc)
+                                      { return entry.last_soc < soc; });
+        if (entry == index.end() || entry->first_soc > to)
+        {
+            fclose(file);
+            continue;
+        }
+
+        // the configuration frame is the first record of the segment
+        uint32_t config_size = 0;
+        if (read_block(file, index.front().offset, stored, block) && block.size() >= ARCHIVE_RECORD_HEADER_SIZE)
+            memcpy(&config_size, block.data() + 8, sizeof(config_size));
+        if (config_size < 16 || block.size() < ARCHIVE_RECORD_HEADER_SIZE + config_size)
+        {
+            fprintf(stderr, "%s: unreadable first block, skipped\n", segment->path.c_str());
+            fclose(file);
+            continue;
+        }
+        if (config.size() != ARCHIVE_RECORD_HEADER_SIZE + config_size ||
+            memcmp(config.data() + ARCHIVE_RECORD_HEADER_SIZE + 14, block.data() + ARCHIVE_RECORD_HEADER_SIZE + 14, config_size - 16) != 0)
+        {
+            config.assign(block.begin(), block.begin() + ARCHIVE_RECORD_HEADER_SIZE + config_size);
+            write_record(output, config.data(), config_size);
+        }
+
+        for (; entry != index.end() && entry->first_soc <= to; entry++)
+        {
+            if (!read_block(file, entry->offset, stored, block))
+            {
+                fprintf(stderr, "%s: unreadable block at %llu, skipped\n", segment->path.c_str(), (unsigned long long)entry->offset);
+                continue;
+            }
+            nb_blocks++;
+            for (size_t pos = 0; pos + ARCHIVE_RECORD_HEADER_SIZE <= block.size();)
+            {
+                uint32_t size;
+                memcpy(&size, block.data() + pos + 8, sizeof(size));
+                const unsigned char *frame = block.data() + pos + ARCHIVE_RECORD_HEADER_SIZE;
+                if (pos + ARCHIVE_RECORD_HEADER_SIZE + size > block.size() || size < 16)
+                    break;
+                uint32_t soc = archive_frame_soc(frame);
+                if (FRAME_TYPE(frame) != 2 && FRAME_TYPE(frame) != 3 && soc >= from && soc <= to)
+                {
+                    if (!write_record(output, block.data() + pos, size))
+                    {
+                        fprintf(stderr, "unable to write %s\n", argv[4]);
+                        return 1;
+                    }
+                    nb_frames++;
+                }
+                pos += ARCHIVE_RECORD_HEADER_SIZE + size;
+            }
+        }
+        fclose(file);
+    }
+    fclose(output);
+    printf("%lu frames extracted from %lu blocks\n", nb_frames, nb_blocks);
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+#ifndef _F_C37118SHMREADER_H
+#define _F_C37118SHMREADER_H
+
+/*
+ * Header only reader of the shared memory ring published by the c37118 south plugin (SHM section).
+ * The segment is mapped read only: readers can join and leave at any time without any effect on the writer.
+ * Link with -lrt on older glibc.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "fc37118shmlayout.h"
+
+#define SHM_READ_RETRIES 100
+
+struct FC37118ShmFrame
+{
+    uint64_t frame_count;
+    uint64_t config_version;
+    uint32_t soc;
+    uint32_t fracsec;
+    double frame_time;
+    std::vector<float> values; // in the order of the channel table
+};
+
+class FC37118ShmReader
+{
+public:
+    FC37118ShmReader() : m_fd(-1), m_map(nullptr), m_map_size(0), m_header(nullptr), m_next(0) {}
+    ~FC37118ShmReader() { close(); }
+
+    /**
+     * @brief map the segment published under name (e.g. "/fc37118")
+     *
+     * @return false if the segment does not exist (yet) or is not a valid segment
+     */
+    bool open(const std::string &name)
+    {
+        close();
+        m_fd = shm_open(name.c_str(), O_RDONLY, 0);
+        struct stat st;
+        if (m_fd < 0 || fstat(m_fd, &st) != 0 || (size_t)st.st_size < sizeof(FC37118ShmHeader))
+        {
+            close();
+            return false;
+        }
+        m_map_size = st.st_size;
+        m_map = mmap(nullptr, m_map_size, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (m_map == MAP_FAILED)
+        {
+            m_map = nullptr;
+            close();
+            return false;
+        }
+        m_header = (const FC37118ShmHeader *)m_map;
+        if (memcmp(m_header->magic, SHM_MAGIC, sizeof(m_header->magic)) != 0 ||
+            m_header->layout_version != SHM_LAYOUT_VERSION ||
+            m_header->slots_offset + (uint64_t)m_header->slot_size * m_header->slot_count > m_map_size)
+        {
+            close();
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        m_next = 0;
+        return true;
+    }
+
+    void close()
+    {
+        if (m_map != nullptr)
+            munmap(m_map, m_map_size);
+        if (m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+        m_map = nullptr;
+        m_header = nullptr;
+    }
+
+    bool is_open() { return m_header != nullptr; }
+
+    /**
+     * @brief true once the writer has stopped: the segment shall be reopened to follow a new writer
+     */
+    bool is_writer_closed() { return m_header->is_closed.load(std::memory_order_acquire) != 0; }
+
+    /**
+     * @brief copy the channel table
+     *
+     * @param config_version set to the configuration version of the table, to be compared with FC37118ShmFrame::config_version
+     */
+    bool channels(std::vector<FC37118ShmChannel> &channels, uint64_t *config_version)
+    {
+        for (int retry = 0; retry < SHM_READ_RETRIES; retry++)
+        {
+            uint64_t seq = m_header->channels_seq.load(std::memory_order_acquire);
+            if (seq & 1)
+                continue;
+            uint32_t nb_channels = std::min(m_header->nb_channels, m_header->max_channels);
+            *config_version = m_header->config_version;
+            auto table = (const FC37118ShmChannel *)((const unsigned char *)m_map + m_header->channels_offset);
+            channels.assign(table, table + nb_channels);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_header->channels_seq.load(std::memory_order_relaxed) == seq)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief read the frames in order, starting with the latest frame published when the reader was opened
+     *
+     * @param nb_lost incremented by the number of frames overwritten before being read
+     * @return false - no new frame
+     */
+    bool next(FC37118ShmFrame &frame, uint64_t *nb_lost)
+    {
+        uint64_t write_count = m_header->write_count.load(std::memory_order_acquire);
+        if (m_next == 0)
+            m_next = write_count > 0 ? write_count : 1;
+        while (m_next <= write_count)
+        {
+            // keep a slot of margin with the writer
+            uint64_t oldest = write_count > m_header->slot_count - 1 ? write_count - m_header->slot_count + 2 : 1;
+            if (m_next < oldest)
+            {
+                *nb_lost += oldest - m_next;
+                m_next = oldest;
+            }
+            if (m_read_slot(m_next, frame))
+            {
+                m_next++;
+                return true;
+            }
+            *nb_lost += 1;
+            m_next++;
+        }
+        return false;
+    }
+
+    /**
+     * @brief read the latest frame published
+     */
+    bool latest(FC37118ShmFrame &frame)
+    {
+        uint64_t write_count = m_header->write_count.load(std::memory_order_acquire);
+        return write_count > 0 && m_read_slot(write_count, frame);
+    }
+
+private:
+    int m_fd;
+    void *m_map;
+    size_t m_map_size;
+    const FC37118ShmHeader *m_header;
+    uint64_t m_next;
+
+    bool m_read_slot(uint64_t frame_count, FC37118ShmFrame &frame)
+    {
+        auto slot = (const FC37118ShmSlotHeader *)((const unsigned char *)m_map + m_header->slots_offset +
+                                                   ((frame_count - 1) % m_header->slot_count) * m_header->slot_size);
+        auto values = (const float *)(slot + 1);
+        for (int retry = 0; retry < SHM_READ_RETRIES; retry++)
+        {
+            uint64_t seq = slot->seq.load(std::memory_order_acquire);
+            if (seq & 1)
+                continue;
+            frame.frame_count = slot->frame_count;
+            frame.config_version = slot->config_version;
+            frame.soc = slot->soc;
+            frame.fracsec = slot->fracsec;
+            frame.frame_time = slot->frame_time;
+            uint32_t nb_channels = std::min(slot->nb_channels, m_header->max_channels);
+            frame.values.assign(values, values + nb_channels);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == seq)
+                return frame.frame_count == frame_count;
+        }
+        return false;
+    }
+};
+
+#endif
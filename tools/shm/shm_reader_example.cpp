@@ -0,0 +1,76 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+/*
+ * Example consumer of the shared memory ring: prints the channel table on each configuration change,
+ * then the frequency of each station for every frame.
+ *
+ * usage: c37118-shm-reader [/fc37118]
+ */
+
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "fc37118shmreader.h"
+
+#define POLL_PERIOD_US 100
+
+static std::string fixed_name(const char *name)
+{
+    return std::string(name, strnlen(name, SHM_NAME_SIZE));
+}
+
+int main(int argc, char **argv)
+{
+    std::string name = argc > 1 ? argv[1] : "/fc37118";
+    FC37118ShmReader reader;
+    std::vector<FC37118ShmChannel> channels;
+    uint64_t config_version = 0, nb_lost = 0;
+    FC37118ShmFrame frame;
+
+    while (true)
+    {
+        if (!reader.is_open() || reader.is_writer_closed())
+        {
+            if (!reader.open(name))
+            {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+            printf("%s opened\n", name.c_str());
+            config_version = 0;
+        }
+        if (!reader.next(frame, &nb_lost))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(POLL_PERIOD_US));
+            continue;
+        }
+        if (frame.config_version != config_version)
+        {
+            if (!reader.channels(channels, &config_version) || config_version != frame.config_version)
+                continue;
+            printf("configuration %lu: %lu channels\n", (unsigned long)config_version, (unsigned long)channels.size());
+            for (size_t i = 0; i < channels.size(); i++)
+                printf("  %3lu %5u %-16s %-16s kind %u\n", (unsigned long)i, channels[i].idcode,
+                       fixed_name(channels[i].station_name).c_str(), fixed_name(channels[i].name).c_str(), channels[i].kind);
+        }
+
+        printf("frame %lu %u.%06u lost %lu:", (unsigned long)frame.frame_count, frame.soc, frame.fracsec & 0x00FFFFFF, (unsigned long)nb_lost);
+        for (size_t i = 0; i < std::min(channels.size(), frame.values.size()); i++)
+        {
+            if (channels[i].kind == SHM_CHANNEL_FREQ)
+                printf(" %u=%.4f Hz", channels[i].idcode, frame.values[i]);
+        }
+        printf("\n");
+    }
+    return 0;
+}
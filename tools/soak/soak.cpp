@@ -0,0 +1,480 @@
+/*
+ * Fledge south plugin.
+
+ * Copyright (c) 2022, RTE (http://www.rte-france.com)*
+
+ * Released under the Apache 2.0 Licence
+ *
+ * Author: Benoit Jeanson <benoit.jeanson at rte-france.com>
+ */
+
+/*
+ * Soak test of the plugin: the FC37118 class is driven for hours, outside of Fledge, by a synthetic PMU listening on
+ * the loopback, its readings going to a stub ingest callback.
+ * - the synthetic PMU answers the HDR, CFG-2 and TURNON commands and streams data frames at DATA_RATE, or with -u as fast
+ *   as the socket allows (batches of frames), to push hundreds of millions of frames in a few hours. It closes the
+ *   connection every third of a cycle, so that the plugin reconnects, and alternates between two configurations (3 or 6
+ *   phasors per station), so that the plugin installs a new configuration on each reconnection.
+ * - every cycle the plugin is stopped, the memory is sampled, and the plugin is reconfigured through set_conf with
+ *   alternately two plugin configurations, then restarted.
+ * - the global operator new / delete of this executable count the allocations of the whole process, plugin, Fledge
+ *   common library and libstdc++ included. The allocations per frame sent are reported each cycle.
+ * The samples taken after the warmup cycles are compared to the first one: the test fails (exit code 1) if the RSS
+ * grew by more than <max RSS growth kB> or the live allocations by more than <max live allocations growth>.
+ *
+ * usage: c37118-soak [-u] [duration s] [cycle s] [warmup cycles] [max RSS growth kB] [max live allocations growth]
+ */
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "fc37118.h"
+#include "fc37118soak.h"
+
+#define SOAK_STREAM_IDCODE 2
+#define SOAK_DATA_RATE 50
+#define SOAK_TIME_BASE 1000000
+#define SOAK_NB_STATIONS 2
+#define SOAK_NB_ANALOGS 2
+#define SOAK_MAX_FRAME_SIZE 512
+// data frames written at once when not paced
+#define SOAK_BATCH_FRAMES 32
+
+// ---------------------------------------------------------------------------------------------------------------------
+// allocation counters, replacing the global operator new / delete of the process
+
+static std::atomic<uint64_t> nb_allocations(0);
+static std::atomic<uint64_t> nb_frees(0);
+
+void *operator new(size_t size)
+{
+    nb_allocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    nb_allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept
+{
+    if (p == nullptr)
+        return;
+    nb_frees.fetch_add(1, std::memory_order_relaxed);
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    operator delete(p);
+}
+
+static int64_t live_allocations()
+{
+    return (int64_t)(nb_allocations.load(std::memory_order_relaxed) - nb_frees.load(std::memory_order_relaxed));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// synthetic PMU
+
+static inline unsigned char *put16(unsigned char *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+    return p + 2;
+}
+
+static inline unsigned char *put32(unsigned char *p, uint32_t v)
+{
+    p = put16(p, v >> 16);
+    return put16(p, v & 0xFFFF);
+}
+
+static inline unsigned char *put_float(unsigned char *p, float v)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return put32(p, bits);
+}
+
+/**
+ * @brief PMU on the loopback streaming float polar phasors. Its frames are built once, or in a fixed buffer for the
+ * data frames, so that it does not allocate while streaming and the allocation counters only reflect the plugin
+ */
+class SyntheticPmu
+{
+public:
+    SyntheticPmu(uint reconnect_s, bool is_paced) : m_reconnect_s(reconnect_s),
+                                                   m_is_paced(is_paced),
+                                                   m_listen_fd(-1),
+                                                   m_is_running(false),
+                                                   m_nb_connections(0),
+                                                   m_nb_frames(0)
+    {
+    }
+
+    ~SyntheticPmu() { stop(); }
+
+    bool start()
+    {
+        for (int variant = 0; variant < 2; variant++)
+            m_build_config(variant);
+        HEADER_Frame header("c37118-soak synthetic PMU");
+        header.IDCODE_set(SOAK_STREAM_IDCODE);
+        unsigned char *buffer;
+        unsigned short size = header.pack(&buffer);
+        m_header.assign(buffer, buffer + size);
+
+        m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t addr_size = sizeof(addr);
+        if (m_listen_fd < 0 || bind(m_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(m_listen_fd, 1) != 0 ||
+            getsockname(m_listen_fd, (struct sockaddr *)&addr, &addr_size) != 0)
+        {
+            perror("synthetic PMU");
+            return false;
+        }
+        m_port = ntohs(addr.sin_port);
+        m_is_running = true;
+        m_thread = std::thread(&SyntheticPmu::m_run, this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (!m_is_running)
+            return;
+        m_is_running = false;
+        shutdown(m_listen_fd, SHUT_RDWR);
+        close(m_listen_fd);
+        m_thread.join();
+    }
+
+    uint16_t get_port() { return m_port; }
+    unsigned long get_nb_connections() { return m_nb_connections; }
+    unsigned long get_nb_frames() { return m_nb_frames; }
+
+private:
+    uint m_reconnect_s;
+    bool m_is_paced;
+    int m_listen_fd;
+    uint16_t m_port;
+    std::atomic<bool> m_is_running;
+    std::thread m_thread;
+    std::atomic<unsigned long> m_nb_connections;
+    std::atomic<unsigned long> m_nb_frames;
+    std::vector<unsigned char> m_header;
+    std::vector<unsigned char> m_configs[2];
+    uint m_nb_phasors[2];
+
+    void m_build_config(int variant)
+    {
+        m_nb_phasors[variant] = 3 * (variant + 1);
+        CONFIG_Frame config;
+        config.IDCODE_set(SOAK_STREAM_IDCODE);
+        config.SOC_set(time(nullptr));
+        config.TIME_BASE_set(SOAK_TIME_BASE);
+        config.DATA_RATE_set(SOAK_DATA_RATE);
+        for (int s = 0; s < SOAK_NB_STATIONS; s++)
+        {
+            auto pmu_station = new PMU_Station("SOAK STATION " + std::to_string(s + 1), 10 + s, true, true, true, true);
+            pmu_station->FORMAT_set(15); // float polar phasors, float analogs, float FREQ / DFREQ
+            for (uint k = 0; k < m_nb_phasors[variant]; k++)
+                pmu_station->PHASOR_add(std::string(k < 3 ? "V" : "I") + (char)('A' + k % 3), k < 3 ? 0 : 1 << 24);
+            for (int k = 0; k < SOAK_NB_ANALOGS; k++)
+                pmu_station->ANALOG_add("AN" + std::to_string(k + 1), 0);
+            pmu_station->FNOM_set(1);
+            pmu_station->CFGCNT_set(variant + 1);
+            config.PMUSTATION_ADD(pmu_station);
+        }
+        unsigned char *buffer;
+        unsigned short size = config.pack(&buffer);
+        m_configs[variant].assign(buffer, buffer + size);
+    }
+
+    size_t m_build_data_frame(int variant, uint64_t index, unsigned char *frame)
+    {
+        uint32_t soc = (uint32_t)(index / SOAK_DATA_RATE);
+        uint32_t fracsec = (uint32_t)(index % SOAK_DATA_RATE) * (SOAK_TIME_BASE / SOAK_DATA_RATE);
+        double t = (double)index / SOAK_DATA_RATE;
+        double frequency = 50.0 + 0.02 * sin(2 * M_PI * t / 60);
+
+        unsigned char *p = put16(frame, 0xAA01);
+        p += 2; // FRAMESIZE
+        p = put16(p, SOAK_STREAM_IDCODE);
+        p = put32(p, soc);
+        p = put32(p, fracsec);
+        for (int s = 0; s < SOAK_NB_STATIONS; s++)
+        {
+            p = put16(p, 0); // STAT
+            for (uint k = 0; k < m_nb_phasors[variant]; k++)
+            {
+                double angle = std::remainder(2 * M_PI * (frequency - 50.0) * t - (k % 3) * 2 * M_PI / 3 - 0.1 * s, 2 * M_PI);
+                p = put_float(p, k < 3 ? 230.0 + sin(t) : 100.0 + 10 * sin(t / 7));
+                p = put_float(p, angle);
+            }
+            p = put_float(p, frequency);
+            p = put_float(p, 0.02 * 2 * M_PI / 60 * cos(2 * M_PI * t / 60));
+            for (int k = 0; k < SOAK_NB_ANALOGS; k++)
+                p = put_float(p, 1000.0 * (k + 1) + sin(t));
+        }
+        size_t size = p - frame + 2;
+        put16(frame + 2, size);
+        put16(p, crc_ccitt(frame, size - 2));
+        return size;
+    }
+
+    static bool m_read_full(int fd, unsigned char *buffer, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t n = read(fd, buffer, size);
+            if (n <= 0)
+                return false;
+            buffer += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    static bool m_write_full(int fd, const unsigned char *buffer, size_t size)
+    {
+        return send(fd, buffer, size, MSG_NOSIGNAL) == (ssize_t)size;
+    }
+
+    void m_run()
+    {
+        while (m_is_running)
+        {
+            int fd = accept(m_listen_fd, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+            m_serve(fd, m_nb_connections++ % 2);
+            close(fd);
+        }
+    }
+
+    /**
+     * @brief dialog with the plugin and stream until the connection is lost or m_reconnect_s elapsed
+     */
+    void m_serve(int fd, int variant)
+    {
+        unsigned char command[SOAK_MAX_FRAME_SIZE], frames[SOAK_MAX_FRAME_SIZE * SOAK_BATCH_FRAMES];
+        bool is_streaming = false;
+        uint64_t index = 0;
+        auto period = std::chrono::microseconds(1000000 / SOAK_DATA_RATE);
+        auto next_frame = std::chrono::steady_clock::now();
+        auto end = next_frame + std::chrono::seconds(m_reconnect_s);
+
+        while (m_is_running && std::chrono::steady_clock::now() < end)
+        {
+            auto now = std::chrono::steady_clock::now();
+            int timeout_ms = !is_streaming ? 100 : (!m_is_paced ? 0 : std::max(0, (int)std::chrono::duration_cast<std::chrono::milliseconds>(next_frame - now).count()));
+            struct pollfd pfd = {fd, POLLIN, 0};
+            int ready = poll(&pfd, 1, timeout_ms);
+            if (ready < 0)
+                return;
+            if (ready > 0)
+            {
+                if (!m_read_full(fd, command, 4))
+                    return;
+                size_t size = (command[2] << 8) | command[3];
+                if (size < 4 || size > SOAK_MAX_FRAME_SIZE || !m_read_full(fd, command + 4, size - 4))
+                    return;
+                if (frame_type(command) != C37118_FRAME_TYPE_COMMAND || size < 16)
+                    continue;
+                uint16_t cmd = (command[14] << 8) | command[15];
+                bool is_sent = true;
+                switch (cmd)
+                {
+                case C37118_CMD_SEND_HDR:
+                    is_sent = m_write_full(fd, m_header.data(), m_header.size());
+                    break;
+                case C37118_CMD_SEND_CONFIGURATION_1:
+                case C37118_CMD_SEND_CONFIGURATION_2:
+                    is_sent = m_write_full(fd, m_configs[variant].data(), m_configs[variant].size());
+                    break;
+                case C37118_CMD_TURNON_TX:
+                    is_streaming = true;
+                    index = (uint64_t)time(nullptr) * SOAK_DATA_RATE;
+                    next_frame = std::chrono::steady_clock::now();
+                    break;
+                case C37118_CMD_TURNOFF_TX:
+                    is_streaming = false;
+                    break;
+                default:
+                    break;
+                }
+                if (!is_sent)
+                    return;
+            }
+            if (is_streaming && !m_is_paced)
+            {
+                // the send blocks while the plugin is behind, the socket paces the stream
+                size_t size = 0;
+                for (int k = 0; k < SOAK_BATCH_FRAMES; k++)
+                    size += m_build_data_frame(variant, index++, frames + size);
+                if (!m_write_full(fd, frames, size))
+                    return;
+                m_nb_frames += SOAK_BATCH_FRAMES;
+            }
+            else if (is_streaming && std::chrono::steady_clock::now() >= next_frame)
+            {
+                size_t size = m_build_data_frame(variant, index++, frames);
+                if (!m_write_full(fd, frames, size))
+                    return;
+                m_nb_frames++;
+                next_frame += period;
+            }
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// plugin driver
+
+static std::atomic<unsigned long> nb_readings(0);
+
+static void stub_ingest(void *data, Reading reading)
+{
+    nb_readings++;
+}
+
+/**
+ * @brief plugin configuration of a cycle, alternating between two sets of sections
+ */
+static std::string soak_conf(uint16_t port, int cycle)
+{
+    std::string conf = "{\"" IP_ADDR "\" : \"127.0.0.1\", \"" IP_PORT "\" : " + std::to_string(port) +
+                       ", \"" RECONNECTION_DELAY "\" : 1, \"" MY_IDCODE "\" : 7, \"" STREAMSOURCE_IDCODE "\" : " +
+                       std::to_string(SOAK_STREAM_IDCODE) + ", \"" STN_IDCODES_FILTER "\" : [], \"" REQUEST_CONFIG_TO_SENDER "\" : true, ";
+    if (cycle % 2 == 0)
+        conf += "\"" SPLIT_STATIONS "\" : true, \"" INGEST_QUEUE "\" : { \"" QUEUE_MAX_READINGS "\" : 1000 }}";
+    else
+        conf += "\"" SPLIT_STATIONS "\" : false, \"" DICTIONARY_LABELS "\" : true, \"" PARALLEL_CONVERSION "\" : { \"" PARALLEL_WORKERS "\" : 2 }, "
+                "\"" VALIDATION "\" : { \"" VAL_FROZEN_FRAMES "\" : 10 }}";
+    return conf;
+}
+
+int main(int argc, char **argv)
+{
+    bool is_paced = !(argc > 1 && strcmp(argv[1], "-u") == 0);
+    if (!is_paced)
+    {
+        argv++;
+        argc--;
+    }
+    if (argc > 6)
+    {
+        fprintf(stderr, "usage: c37118-soak [-u] [duration s] [cycle s] [warmup cycles] [max RSS growth kB] [max live allocations growth]\n");
+        return 2;
+    }
+    uint duration_s = argc > 1 ? strtoul(argv[1], nullptr, 10) : 3600;
+    uint cycle_s = argc > 2 ? strtoul(argv[2], nullptr, 10) : 60;
+    uint warmup_cycles = argc > 3 ? strtoul(argv[3], nullptr, 10) : 3;
+    long max_growth_kb = argc > 4 ? strtol(argv[4], nullptr, 10) : 10240;
+    long max_live_growth = argc > 5 ? strtol(argv[5], nullptr, 10) : 1000;
+    if (cycle_s < 6 || warmup_cycles == 0 || duration_s < cycle_s * (warmup_cycles + 1))
+    {
+        fprintf(stderr, "the cycle shall last at least 6 s, and the duration cover at least one warmup cycle and one more\n");
+        return 2;
+    }
+
+    SyntheticPmu pmu(cycle_s / 3, is_paced);
+    if (!pmu.start())
+        return 2;
+
+    FC37118 *plugin = new FC37118();
+    plugin->register_ingest(nullptr, stub_ingest);
+
+    long baseline_rss_kb = -1, max_growth_seen_kb = 0, growth_kb = 0;
+    int64_t baseline_live = 0, live_growth = 0;
+    uint nb_cycles = duration_s / cycle_s;
+    unsigned long previous_frames = 0;
+    uint64_t previous_allocations = 0;
+    for (uint cycle = 0; cycle < nb_cycles; cycle++)
+    {
+        if (!plugin->set_conf(soak_conf(pmu.get_port(), cycle)))
+        {
+            fprintf(stderr, "set_conf failed\n");
+            return 2;
+        }
+        plugin->start();
+        Logger::getLogger()->setMinLevel("warning");
+        std::this_thread::sleep_for(std::chrono::seconds(cycle_s));
+        plugin->stop();
+
+        // sampled with the plugin stopped: no reading nor frame in flight
+        long rss_kb = get_rss_kb();
+        int64_t live = live_allocations();
+        unsigned long frames = pmu.get_nb_frames();
+        uint64_t allocations = nb_allocations.load(std::memory_order_relaxed);
+        double allocations_per_frame = frames > previous_frames ? (double)(allocations - previous_allocations) / (frames - previous_frames) : 0;
+        previous_frames = frames;
+        previous_allocations = allocations;
+        printf("cycle %u: %lu PMU frames, %lu connections, %lu readings, RSS %ld kB, %lld live allocations, %.1f allocations per frame\n",
+               cycle + 1, frames, pmu.get_nb_connections(), (unsigned long)nb_readings, rss_kb, (long long)live, allocations_per_frame);
+        fflush(stdout);
+        if (cycle + 1 == warmup_cycles)
+        {
+            baseline_rss_kb = rss_kb;
+            baseline_live = live;
+            continue;
+        }
+        if (baseline_rss_kb < 0)
+            continue;
+        growth_kb = rss_kb - baseline_rss_kb;
+        live_growth = live - baseline_live;
+        max_growth_seen_kb = std::max(max_growth_seen_kb, growth_kb);
+    }
+    delete plugin;
+    pmu.stop();
+
+    bool is_passed = nb_readings > 0 && growth_kb <= max_growth_kb && live_growth <= max_live_growth;
+    printf("%s: RSS growth %ld kB (max %ld kB during the run, limit %ld kB), live allocations growth %lld (limit %ld), %lu readings\n",
+           is_passed ? "PASSED" : "FAILED", growth_kb, max_growth_seen_kb, max_growth_kb, (long long)live_growth, max_live_growth,
+           (unsigned long)nb_readings);
+    return is_passed ? 0 : 1;
+}